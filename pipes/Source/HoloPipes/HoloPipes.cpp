@@ -1,8 +1,8 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#include "HoloPipes.h"
-#include "Modules/ModuleManager.h"
-
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, HoloPipes, "HoloPipes" );
-
-DEFINE_LOG_CATEGORY(HoloPipesLog);
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "HoloPipes.h"
+#include "Modules/ModuleManager.h"
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, HoloPipes, "HoloPipes" );
+
+DEFINE_LOG_CATEGORY(HoloPipesLog);
@@ -1,11 +1,11 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-
-DECLARE_LOG_CATEGORY_EXTERN(HoloPipesLog, Log, All);
-
-#include "Windows/AllowWindowsPlatformTypes.h"
-
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+DECLARE_LOG_CATEGORY_EXTERN(HoloPipesLog, Log, All);
+
+#include "Windows/AllowWindowsPlatformTypes.h"
+
 #include "Windows/HideWindowsPlatformTypes.h"
\ No newline at end of file
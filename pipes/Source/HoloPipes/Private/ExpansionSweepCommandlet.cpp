@@ -0,0 +1,100 @@
+#include "ExpansionSweepCommandlet.h"
+#include "PPipesGameMode.h"
+#include "LevelGenerator.h"
+#include "Misc/Parse.h"
+#include "HAL/PlatformTime.h"
+
+UExpansionSweepCommandlet::UExpansionSweepCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UExpansionSweepCommandlet::Main(const FString& params)
+{
+    FString sidesParam = L"16,32,64";
+    int32 level = 400;
+    int32 beamWidth = 0;
+    int32 memoryBudgetKB = 0;
+
+    FParse::Value(*params, L"Sides=", sidesParam);
+    FParse::Value(*params, L"Level=", level);
+    FParse::Value(*params, L"BeamWidth=", beamWidth);
+    FParse::Value(*params, L"MemoryBudgetKB=", memoryBudgetKB);
+
+    TArray<FString> sides;
+    sidesParam.ParseIntoArray(sides, L",");
+
+    if (sides.Num() == 0)
+    {
+        UE_LOG(HoloPipesLog, Error, L"ExpansionSweep - Sides must list at least one play space size");
+        return 1;
+    }
+
+    FGenerateOptions options = {};
+    GetMutableDefault<APPipesGameMode>()->BuildOptionsForLevel(level, options);
+
+    options.StreamPipes = false;
+    options.BeamWidth = beamWidth;
+    options.MemoryBudgetKB = memoryBudgetKB;
+
+    UE_LOG(HoloPipesLog, Display, L"ExpansionSweep - Level %d, %d pipes, beam width %d, memory budget %d KB",
+        level, options.MaxNumPipes, beamWidth, memoryBudgetKB);
+
+    // One generator for each way of routing, so each size only pays for growing the grid
+    LevelGenerator hierarchical;
+    LevelGenerator flat;
+    flat.SetHierarchicalRouting(false);
+
+    int32 failures = 0;
+    int64 previousExpansions = 0;
+    int32 previousSide = 0;
+
+    for (const FString& side : sides)
+    {
+        options.PlaySpaceSize = FCString::Atoi(*side);
+
+        double start = FPlatformTime::Seconds();
+        const bool hierarchicalSuccess = hierarchical.GenerateLevelSync(options);
+        const double hierarchicalSeconds = FPlatformTime::Seconds() - start;
+
+        start = FPlatformTime::Seconds();
+        const bool flatSuccess = flat.GenerateLevelSync(options);
+        const double flatSeconds = FPlatformTime::Seconds() - start;
+
+        const int64 hierarchicalExpansions = hierarchical.GetLastExpansionCount();
+        const int64 flatExpansions = flat.GetLastExpansionCount();
+
+        UE_LOG(HoloPipesLog, Display, L"ExpansionSweep - Side %d: hierarchical %s, %lld expansions in %.3f s | flat %s, %lld expansions in %.3f s | %.2fx fewer expansions, estimated %llu KB",
+            options.PlaySpaceSize,
+            hierarchicalSuccess ? L"generated" : L"FAILED", hierarchicalExpansions, hierarchicalSeconds,
+            flatSuccess ? L"generated" : L"FAILED", flatExpansions, flatSeconds,
+            (hierarchicalExpansions > 0) ? static_cast<double>(flatExpansions) / hierarchicalExpansions : 0.0,
+            LevelGenerator::EstimateMemoryKB(options));
+
+        // Against the growth of the play space, so sublinear growth shows up as a ratio below 1
+        if (hierarchicalSuccess && previousExpansions > 0 && previousSide > 0)
+        {
+            const double cellGrowth = FMath::Pow(static_cast<double>(options.PlaySpaceSize) / previousSide, 3.0);
+            const double expansionGrowth = static_cast<double>(hierarchicalExpansions) / previousExpansions;
+
+            UE_LOG(HoloPipesLog, Display, L"ExpansionSweep - Side %d to %d: %.2fx the cells, %.2fx the hierarchical expansions (%.2f of linear)",
+                previousSide, options.PlaySpaceSize, cellGrowth, expansionGrowth, expansionGrowth / cellGrowth);
+        }
+
+        if (hierarchicalSuccess)
+        {
+            previousExpansions = hierarchicalExpansions;
+            previousSide = options.PlaySpaceSize;
+        }
+
+        if (!hierarchicalSuccess || !flatSuccess)
+        {
+            failures++;
+        }
+    }
+
+    return (failures == 0) ? 0 : 1;
+}
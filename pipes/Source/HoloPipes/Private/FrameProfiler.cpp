@@ -0,0 +1,290 @@
+#include "FrameProfiler.h"
+#include "HoloPipes.h"
+#include "Misc/CoreDelegates.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "Async/Async.h"
+#include <algorithm>
+#include <vector>
+
+namespace
+{
+    const TCHAR* const ScopeNames[] =
+    {
+        L"GridGaze",
+        L"GridMarkGaze",
+        L"GridFocus",
+        L"GridDrag",
+        L"GridRotate",
+        L"GridToolbox",
+        L"GridCursor",
+        L"GridResolve",
+        L"GridPopulate",
+        L"GridPipeEvents",
+        L"GridResolveSnapshot",
+        L"GridResolveWorker",
+        L"GridResolveApply",
+        L"GameModeTick",
+        L"GameModeSave",
+        L"GenerateRoute",
+        L"GenerateFinalize",
+        L"GenerateMutate",
+        L"GenerateSolve"
+    };
+
+    static_assert(ARRAYSIZE(ScopeNames) == static_cast<int>(ProfileScope::Count), "A name is needed for each scope");
+
+    const TCHAR* const CounterNames[] =
+    {
+        L"PipeEventsRequested",
+        L"PipeEventsFired",
+        L"PipesSpawned",
+        L"PipesReused",
+        L"PipesReleased",
+        L"PipesPopulated",
+        L"PipesRetired",
+        L"PipesResolved",
+        L"TransformsInverted"
+    };
+
+    static_assert(ARRAYSIZE(CounterNames) == static_cast<int>(ProfileCounter::Count), "A name is needed for each counter");
+
+    const TCHAR* const GeneratorStatusNames[] = { L"Idle", L"Generating", L"Canceling", L"Failed", L"Complete" };
+
+    constexpr int ScopeCount = static_cast<int>(ProfileScope::Count);
+    constexpr int CounterCount = static_cast<int>(ProfileCounter::Count);
+}
+
+FrameProfiler& FrameProfiler::Get()
+{
+    // Never destroyed, so it can't go away before the end frame delegate it's bound to
+    static FrameProfiler* profiler = new FrameProfiler();
+    return *profiler;
+}
+
+const TCHAR* FrameProfiler::GetScopeName(ProfileScope scope)
+{
+    const int index = static_cast<int>(scope);
+    return (index >= 0 && index < ScopeCount) ? ScopeNames[index] : L"Unknown";
+}
+
+FrameProfiler::FrameProfiler()
+{
+    for (std::atomic<uint64>& current : m_current)
+    {
+        current.store(0, std::memory_order_relaxed);
+    }
+
+    for (std::atomic<uint32>& current : m_currentCounts)
+    {
+        current.store(0, std::memory_order_relaxed);
+    }
+
+    m_generatorStatus.store(static_cast<uint8>(GeneratorStatus::Idle), std::memory_order_relaxed);
+    m_dumping.store(false);
+
+    m_frameStart = FPlatformTime::Cycles64();
+
+    FCoreDelegates::OnEndFrame.AddRaw(this, &FrameProfiler::EndFrame);
+}
+
+void FrameProfiler::TakeFrame(ProfileFrame& frame)
+{
+    for (int i = 0; i < ScopeCount; i++)
+    {
+        frame.Cycles[i] = m_current[i].exchange(0, std::memory_order_relaxed);
+    }
+
+    for (int i = 0; i < CounterCount; i++)
+    {
+        frame.Counts[i] = m_currentCounts[i].exchange(0, std::memory_order_relaxed);
+    }
+
+    frame.Number = m_frameNumber++;
+    frame.Generator = static_cast<GeneratorStatus>(m_generatorStatus.load(std::memory_order_relaxed));
+
+    const uint64 now = FPlatformTime::Cycles64();
+    frame.FrameCycles = now - m_frameStart;
+    m_frameStart = now;
+}
+
+void FrameProfiler::EndFrame()
+{
+    ProfileFrame& frame = m_frames[m_next];
+    TakeFrame(frame);
+
+    m_next = (m_next + 1) % FrameCount;
+    m_count = FMath::Min(m_count + 1, FrameCount);
+
+    if (m_hitchCycles > 0 && m_count == FrameCount && frame.FrameCycles > m_hitchCycles)
+    {
+        DumpHitch();
+    }
+}
+
+void FrameProfiler::SetHitchThreshold(float thresholdMs, const FString& directory)
+{
+    // Not while a dump might be reading the directory
+    if (m_dumping.load())
+    {
+        return;
+    }
+
+    m_hitchCycles = (thresholdMs > 0.0f) ? static_cast<uint64>(thresholdMs / (FPlatformTime::GetSecondsPerCycle64() * 1000.0)) : 0;
+    m_hitchDirectory = directory;
+}
+
+void FrameProfiler::DumpHitch()
+{
+    // Hitches tend to come in runs, and the dump already in flight covers the ones right after it
+    bool expected = false;
+    if (!m_dumping.compare_exchange_strong(expected, true))
+    {
+        return;
+    }
+
+    for (int32 age = m_count - 1; age >= 0; age--)
+    {
+        m_dumpFrames[m_count - 1 - age] = GetFrame(age);
+    }
+
+    m_dumpCount = m_count;
+
+    const ProfileFrame& hitch = m_dumpFrames[m_dumpCount - 1];
+    UE_LOG(HoloPipesLog, Warning, L"FrameProfiler - Frame %llu took %.2f ms, writing the last %d frames to %s",
+        hitch.Number, CyclesToMs(hitch.FrameCycles), m_dumpCount, *m_hitchDirectory);
+
+    Async(EAsyncExecution::ThreadPool, [this]()
+    {
+        const ProfileFrame& last = m_dumpFrames[m_dumpCount - 1];
+        const FString path = FPaths::Combine(m_hitchDirectory, FString::Printf(L"Hitch-%s-%llu.csv", *FDateTime::Now().ToString(), last.Number));
+
+        FString csv;
+        FormatCsv(m_dumpFrames, m_dumpCount, csv);
+
+        if (!FFileHelper::SaveStringToFile(csv, *path))
+        {
+            UE_LOG(HoloPipesLog, Error, L"FrameProfiler - Unable to write %s", *path);
+        }
+
+        m_dumping.store(false);
+    });
+}
+
+void FrameProfiler::Reset()
+{
+    ProfileFrame discard;
+    TakeFrame(discard);
+
+    m_next = 0;
+    m_count = 0;
+}
+
+const ProfileFrame& FrameProfiler::GetFrame(int32 age) const
+{
+    check(age >= 0 && age < m_count);
+    return m_frames[(m_next - 1 - age + FrameCount) % FrameCount];
+}
+
+ProfileStats FrameProfiler::GetStats(ProfileScope scope) const
+{
+    return ComputeStats(static_cast<int>(scope));
+}
+
+ProfileStats FrameProfiler::GetFrameStats() const
+{
+    return ComputeStats(ScopeCount);
+}
+
+ProfileStats FrameProfiler::ComputeStats(int scope) const
+{
+    ProfileStats stats;
+    if (m_count == 0)
+    {
+        return stats;
+    }
+
+    double values[FrameCount];
+    double total = 0.0;
+
+    for (int32 age = 0; age < m_count; age++)
+    {
+        const ProfileFrame& frame = GetFrame(age);
+        values[age] = CyclesToMs((scope < ScopeCount) ? frame.Cycles[scope] : frame.FrameCycles);
+        total += values[age];
+    }
+
+    std::sort(values, values + m_count);
+
+    stats.MinMs = values[0];
+    stats.MaxMs = values[m_count - 1];
+    stats.AvgMs = total / m_count;
+    stats.P99Ms = values[FMath::Min(m_count - 1, (m_count * 99) / 100)];
+
+    return stats;
+}
+
+void FrameProfiler::LogStats() const
+{
+    UE_LOG(HoloPipesLog, Display, L"FrameProfiler - Last %d frames, in ms (min / avg / p99 / max)", m_count);
+
+    for (int scope = 0; scope <= ScopeCount; scope++)
+    {
+        const ProfileStats stats = ComputeStats(scope);
+        if (scope == ScopeCount || stats.MaxMs > 0.0)
+        {
+            UE_LOG(HoloPipesLog, Display, L"FrameProfiler - %-16s %8.3f %8.3f %8.3f %8.3f",
+                (scope < ScopeCount) ? ScopeNames[scope] : L"Frame", stats.MinMs, stats.AvgMs, stats.P99Ms, stats.MaxMs);
+        }
+    }
+}
+
+bool FrameProfiler::ExportCsv(const FString& path) const
+{
+    std::vector<ProfileFrame> frames(m_count);
+    for (int32 age = m_count - 1; age >= 0; age--)
+    {
+        frames[m_count - 1 - age] = GetFrame(age);
+    }
+
+    FString csv;
+    FormatCsv(frames.data(), m_count, csv);
+
+    return FFileHelper::SaveStringToFile(csv, *path);
+}
+
+void FrameProfiler::FormatCsv(const ProfileFrame* frames, int32 count, FString& csv)
+{
+    csv = L"Frame";
+    for (const TCHAR* name : ScopeNames)
+    {
+        csv += FString::Printf(L",%sMs", name);
+    }
+
+    for (const TCHAR* name : CounterNames)
+    {
+        csv += FString::Printf(L",%s", name);
+    }
+
+    csv += L",Generator,FrameMs\n";
+
+    for (int32 i = 0; i < count; i++)
+    {
+        const ProfileFrame& frame = frames[i];
+
+        csv += FString::Printf(L"%llu", frame.Number);
+        for (uint64 cycles : frame.Cycles)
+        {
+            csv += FString::Printf(L",%.4f", CyclesToMs(cycles));
+        }
+
+        for (uint32 counted : frame.Counts)
+        {
+            csv += FString::Printf(L",%u", counted);
+        }
+
+        const int generator = static_cast<int>(frame.Generator);
+        csv += FString::Printf(L",%s,%.4f\n", (generator < static_cast<int>(ARRAYSIZE(GeneratorStatusNames))) ? GeneratorStatusNames[generator] : L"Unknown",
+            CyclesToMs(frame.FrameCycles));
+    }
+}
@@ -0,0 +1,189 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "HAL/PlatformTime.h"
+#include "LevelGenerator.h"
+#include <atomic>
+
+// The parts of a frame HOLOPIPES_PROFILE_SCOPE can time
+enum class ProfileScope : uint8
+{
+    // APPipeGrid
+    GridGaze,
+    GridMarkGaze,
+    GridFocus,
+    GridDrag,
+    GridRotate,
+    GridToolbox,
+    GridCursor,
+    GridResolve,
+    GridPopulate,
+    GridPipeEvents,
+
+    // APPipeGrid's async resolve. The worker part counts toward the frame it finishes in
+    GridResolveSnapshot,
+    GridResolveWorker,
+    GridResolveApply,
+
+    // APPipesGameMode
+    GameModeTick,
+    GameModeSave,
+
+    // LevelGenerator. These run on the generator's thread, and count toward the frame they finish in
+    GenerateRoute,
+    GenerateFinalize,
+    GenerateMutate,
+    GenerateSolve,
+
+    Count
+};
+
+// The events HOLOPIPES_PROFILE_COUNT can count
+enum class ProfileCounter : uint8
+{
+    PipeEventsRequested,
+    PipeEventsFired,
+    PipesSpawned,
+    PipesReused,
+    PipesReleased,
+    PipesPopulated,
+    PipesRetired,
+    PipesResolved,
+    TransformsInverted,
+
+    Count
+};
+
+struct ProfileFrame
+{
+    uint64 Number = 0;
+
+    uint64 Cycles[static_cast<int>(ProfileScope::Count)] = {};
+    uint32 Counts[static_cast<int>(ProfileCounter::Count)] = {};
+
+    // The game's generator, as of the game mode's tick (see FrameProfiler::SetGeneratorStatus)
+    GeneratorStatus Generator = GeneratorStatus::Idle;
+
+    // From the end of the frame before to the end of this one
+    uint64 FrameCycles = 0;
+};
+
+struct ProfileStats
+{
+    double MinMs = 0.0;
+    double AvgMs = 0.0;
+    double P99Ms = 0.0;
+    double MaxMs = 0.0;
+};
+
+//
+// Adds up the time spent in each ProfileScope and the events of each ProfileCounter over a frame, and
+// keeps the last FrameCount frames in a ring for statistics and export. Scopes and counters can be
+// used from any thread. Times are inclusive, so a resolve done while dragging counts toward both.
+// Frames end with the engine's (FCoreDelegates::OnEndFrame).
+//
+// It doubles as a flight recorder for hitches. Once a hitch threshold is set, a frame that takes
+// longer than it has the whole ring (the frames leading up to it) written out on a worker thread, so
+// rare spikes can be looked at after the fact. Nothing is allocated while recording frames
+//
+class FrameProfiler
+{
+public:
+
+    static constexpr int32 FrameCount = 256;
+
+    static FrameProfiler& Get();
+    static const TCHAR* GetScopeName(ProfileScope scope);
+    static double CyclesToMs(uint64 cycles) { return FPlatformTime::ToMilliseconds64(cycles); }
+
+    void Add(ProfileScope scope, uint64 cycles)
+    {
+        m_current[static_cast<int>(scope)].fetch_add(cycles, std::memory_order_relaxed);
+    }
+
+    void AddCount(ProfileCounter counter, uint32 count)
+    {
+        m_currentCounts[static_cast<int>(counter)].fetch_add(count, std::memory_order_relaxed);
+    }
+
+    void SetGeneratorStatus(GeneratorStatus status)
+    {
+        m_generatorStatus.store(static_cast<uint8>(status), std::memory_order_relaxed);
+    }
+
+    // Frames longer than thresholdMs are written to a CSV in directory. 0 turns this off. Hitches aren't
+    // looked for until the ring has filled, which also skips the frames spent loading
+    void SetHitchThreshold(float thresholdMs, const FString& directory);
+
+    // Takes what has been timed since the last frame ended, without it going into the ring. For tools that
+    // run many frames' worth of work within one (see APPipeGrid::ReplayInput)
+    void TakeFrame(ProfileFrame& frame);
+
+    void EndFrame();
+    void Reset();
+
+    // age 0 is the last frame to end
+    int32 GetFrameCount() const { return m_count; }
+    const ProfileFrame& GetFrame(int32 age) const;
+
+    ProfileStats GetStats(ProfileScope scope) const;
+    ProfileStats GetFrameStats() const;
+
+    void LogStats() const;
+
+    // One row per frame held, oldest first, in milliseconds
+    bool ExportCsv(const FString& path) const;
+
+private:
+
+    FrameProfiler();
+
+    ProfileStats ComputeStats(int scope) const;
+
+    static void FormatCsv(const ProfileFrame* frames, int32 count, FString& csv);
+    void DumpHitch();
+
+    std::atomic<uint64> m_current[static_cast<int>(ProfileScope::Count)];
+    std::atomic<uint32> m_currentCounts[static_cast<int>(ProfileCounter::Count)];
+    std::atomic<uint8> m_generatorStatus;
+    uint64 m_frameStart = 0;
+    uint64 m_frameNumber = 0;
+
+    ProfileFrame m_frames[FrameCount];
+    int32 m_next = 0;
+    int32 m_count = 0;
+
+    // Frames being written out, oldest first. Only touched by the dump while m_dumping is set
+    uint64 m_hitchCycles = 0;
+    FString m_hitchDirectory;
+    ProfileFrame m_dumpFrames[FrameCount];
+    int32 m_dumpCount = 0;
+    std::atomic<bool> m_dumping;
+};
+
+class FrameProfileScope
+{
+public:
+
+    explicit FrameProfileScope(ProfileScope scope) : m_scope(scope), m_start(FPlatformTime::Cycles64())
+    {
+    }
+
+    ~FrameProfileScope()
+    {
+        FrameProfiler::Get().Add(m_scope, FPlatformTime::Cycles64() - m_start);
+    }
+
+private:
+
+    ProfileScope m_scope;
+    uint64 m_start;
+};
+
+#if !UE_BUILD_SHIPPING
+#define HOLOPIPES_PROFILE_SCOPE(scope) FrameProfileScope PREPROCESSOR_JOIN(frameProfileScope, __LINE__)(ProfileScope::scope)
+#define HOLOPIPES_PROFILE_COUNT(counter, count) FrameProfiler::Get().AddCount(ProfileCounter::counter, count)
+#else
+#define HOLOPIPES_PROFILE_SCOPE(scope)
+#define HOLOPIPES_PROFILE_COUNT(counter, count)
+#endif
@@ -0,0 +1,199 @@
+#include "GeneratorJitterCommandlet.h"
+#include "PPipesGameMode.h"
+#include "LevelGenerator.h"
+#include "Misc/Parse.h"
+#include "HAL/PlatformTime.h"
+#include "HAL/PlatformProcess.h"
+#include <vector>
+#include <algorithm>
+#include <cmath>
+
+namespace
+{
+    // Stand in for a frame's worth of game and render work. The result is returned so the loop
+    // can't be optimized away
+    float DoFrameWork(int64 iterations)
+    {
+        float value = 1.0f;
+        for (int64 i = 0; i < iterations; i++)
+        {
+            value = std::sqrt(value + static_cast<float>(i & 0xff));
+        }
+
+        return value;
+    }
+
+    int64 CalibrateFrameWork(double workMs)
+    {
+        int64 iterations = 1000;
+        double seconds = 0.0;
+
+        // Keep doubling until the measurement is long enough to trust, then scale to the target
+        while (seconds < 0.05)
+        {
+            iterations *= 2;
+
+            const double start = FPlatformTime::Seconds();
+            DoFrameWork(iterations);
+            seconds = FPlatformTime::Seconds() - start;
+        }
+
+        return std::max<int64>(1, static_cast<int64>(iterations * (workMs / 1000.0) / seconds));
+    }
+
+    struct FrameStats
+    {
+        double MeanMs = 0.0;
+        double P50Ms = 0.0;
+        double P99Ms = 0.0;
+        double MaxMs = 0.0;
+        int32 Missed = 0;
+        int32 LevelsGenerated = 0;
+    };
+
+    // Runs the frame loop. If generator is given, it is kept busy generating levels for the whole run
+    FrameStats RunFrames(int32 frames, double frameMs, int64 workIterations, LevelGenerator* generator, FGenerateOptions options)
+    {
+        std::vector<double> workMs;
+        workMs.reserve(frames);
+
+        FrameStats stats;
+
+        if (generator)
+        {
+            generator->GenerateLevel(options);
+        }
+
+        for (int32 frame = 0; frame < frames; frame++)
+        {
+            const double frameStart = FPlatformTime::Seconds();
+
+            DoFrameWork(workIterations);
+
+            const double workEnd = FPlatformTime::Seconds();
+            workMs.push_back((workEnd - frameStart) * 1000.0);
+
+            if (generator)
+            {
+                GeneratorStatus status = generator->GetStatus();
+                if (status == GeneratorStatus::Complete || status == GeneratorStatus::Failed)
+                {
+                    stats.LevelsGenerated++;
+                    options.Level++;
+                    generator->GenerateLevel(options);
+                }
+            }
+
+            // Wait out the rest of the frame, as vsync would
+            const double remaining = (frameMs / 1000.0) - (FPlatformTime::Seconds() - frameStart);
+            if (remaining > 0.0)
+            {
+                FPlatformProcess::Sleep(static_cast<float>(remaining));
+            }
+            else
+            {
+                stats.Missed++;
+            }
+        }
+
+        if (generator)
+        {
+            generator->CancelLevel();
+        }
+
+        std::sort(workMs.begin(), workMs.end());
+
+        for (double ms : workMs)
+        {
+            stats.MeanMs += ms;
+        }
+
+        stats.MeanMs /= workMs.size();
+        stats.P50Ms = workMs[workMs.size() / 2];
+        stats.P99Ms = workMs[std::min(workMs.size() - 1, (workMs.size() * 99) / 100)];
+        stats.MaxMs = workMs.back();
+
+        return stats;
+    }
+
+    void LogStats(const TCHAR* name, const FrameStats& stats, int32 frames)
+    {
+        UE_LOG(HoloPipesLog, Display, L"GeneratorJitter - %s: work mean %.2f ms, p50 %.2f ms, p99 %.2f ms, max %.2f ms, %d / %d frames missed, %d levels generated",
+            name, stats.MeanMs, stats.P50Ms, stats.P99Ms, stats.MaxMs, stats.Missed, frames, stats.LevelsGenerated);
+    }
+}
+
+UGeneratorJitterCommandlet::UGeneratorJitterCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UGeneratorJitterCommandlet::Main(const FString& params)
+{
+    int32 frames = 600;
+    float frameMs = 16.67f;
+    float workMs = 8.0f;
+    int32 level = 200;
+    FString priority = L"Normal";
+    int64 affinity = 0;
+    int32 yieldEvery = 0;
+    int64 frameAffinity = 0;
+
+    FParse::Value(*params, L"Frames=", frames);
+    FParse::Value(*params, L"FrameMs=", frameMs);
+    FParse::Value(*params, L"WorkMs=", workMs);
+    FParse::Value(*params, L"Level=", level);
+    FParse::Value(*params, L"Priority=", priority);
+    FParse::Value(*params, L"Affinity=", affinity);
+    FParse::Value(*params, L"YieldEvery=", yieldEvery);
+    FParse::Value(*params, L"FrameAffinity=", frameAffinity);
+
+    if (frames < 1 || frameMs <= 0.0f || workMs <= 0.0f || workMs >= frameMs)
+    {
+        UE_LOG(HoloPipesLog, Error, L"GeneratorJitter - Frames must be at least 1, and WorkMs between 0 and FrameMs");
+        return 1;
+    }
+
+    FGenerateOptions options = {};
+    GetMutableDefault<APPipesGameMode>()->BuildOptionsForLevel(level, options);
+
+    options.StreamPipes = false;
+    options.AffinityMask = affinity;
+    options.YieldEveryExpansions = yieldEvery;
+
+    if (priority.Equals(L"BelowNormal", ESearchCase::IgnoreCase))
+    {
+        options.ThreadPriority = EGeneratorPriority::BelowNormal;
+    }
+    else if (priority.Equals(L"Lowest", ESearchCase::IgnoreCase))
+    {
+        options.ThreadPriority = EGeneratorPriority::Lowest;
+    }
+    else
+    {
+        options.ThreadPriority = EGeneratorPriority::Normal;
+    }
+
+    // Pin the frame loop if asked, to simulate the render thread owning a core
+    if (frameAffinity != 0)
+    {
+        FPlatformProcess::SetThreadAffinityMask(static_cast<uint64>(frameAffinity));
+    }
+
+    const int64 workIterations = CalibrateFrameWork(workMs);
+
+    UE_LOG(HoloPipesLog, Display, L"GeneratorJitter - %d frames of %.2f ms with %.2f ms of work, generating from level %d (priority %s, affinity 0x%llx, yield every %d)",
+        frames, frameMs, workMs, level, *priority, affinity, yieldEvery);
+
+    const FrameStats baseline = RunFrames(frames, frameMs, workIterations, nullptr, options);
+    LogStats(L"Idle", baseline, frames);
+
+    LevelGenerator generator;
+    const FrameStats loaded = RunFrames(frames, frameMs, workIterations, &generator, options);
+    LogStats(L"Generating", loaded, frames);
+
+    return 0;
+}
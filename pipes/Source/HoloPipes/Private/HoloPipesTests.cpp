@@ -0,0 +1,973 @@
+
+#include "PPipeGrid_Internal.h"
+#include "Misc/AutomationTest.h"
+#include "HAL/PlatformTime.h"
+#include "PPipesGameMode.h"
+#include "Engine/Engine.h"
+#include "Misc/Paths.h"
+#include <algorithm>
+#include <functional>
+
+#if WITH_DEV_AUTOMATION_TESTS
+
+// Checks of the grid's internals against the simpler code each one replaced. Run them from the
+// Session Frontend, or headless with -ExecCmds="Automation RunTests HoloPipes; Quit". Timings are
+// reported as info, and only disagreements fail a test
+
+namespace
+{
+    // ---- Grid storage ----
+
+    // What the grid used before PipeGridStorage
+    using HashedPipeGrid = std::unordered_map<FPipeGridCoordinate, GridPipe, std::function<size_t(const FPipeGridCoordinate&)>>;
+
+    template <class TGrid>
+    void TimeGridStorage(FAutomationTestBase& test, const TCHAR* name, TGrid& grid, const std::vector<FPipeGridCoordinate>& probes, int32 iterations)
+    {
+        int64 found = 0;
+
+        double start = FPlatformTime::Seconds();
+        for (int32 i = 0; i < iterations; i++)
+        {
+            for (const FPipeGridCoordinate& probe : probes)
+            {
+                if (grid.find(probe) != grid.end())
+                {
+                    found++;
+                }
+            }
+        }
+        const double lookupSeconds = FPlatformTime::Seconds() - start;
+
+        // Sum something out of each entry so the loop can't be skipped
+        int64 visited = 0;
+        int64 checksum = 0;
+
+        start = FPlatformTime::Seconds();
+        for (int32 i = 0; i < iterations; i++)
+        {
+            for (const auto& entry : grid)
+            {
+                checksum += entry.second.currentPipeClass;
+                visited++;
+            }
+        }
+        const double iterateSeconds = FPlatformTime::Seconds() - start;
+
+        test.AddInfo(FString::Printf(L"%s: %.2f ns per lookup, %.2f ns per entry iterated (%lld found, checksum %lld)",
+            name,
+            (lookupSeconds * 1e9) / (static_cast<double>(iterations) * probes.size()),
+            (visited > 0 ? (iterateSeconds * 1e9) / visited : 0.0),
+            found, checksum));
+    }
+
+    void CheckGridStorage(FAutomationTestBase& test, int32 playableGridSize, int32 iterations)
+    {
+        PipeGridStorage<GridPipe> storage;
+        HashedPipeGrid hashed(0, FPipeGridCoordinate::HashOf);
+
+        // Fill about a third of the play area, which is typical of a generated level, and probe every
+        // cell of it plus a border, so that lookups are a mix of hits and misses
+        FRandomStream random(playableGridSize);
+        std::vector<FPipeGridCoordinate> probes;
+
+        int playableMin = -(playableGridSize / 2);
+        int playableMax = playableMin + playableGridSize - 1;
+
+        for (int z = playableMin - 1; z <= playableMax + 1; z++)
+        {
+            for (int y = playableMin - 1; y <= playableMax + 1; y++)
+            {
+                for (int x = playableMin - 1; x <= playableMax + 1; x++)
+                {
+                    FPipeGridCoordinate coord = { x, y, z };
+                    probes.push_back(coord);
+
+                    bool inside = (x >= playableMin && x <= playableMax && y >= playableMin && y <= playableMax && z >= playableMin && z <= playableMax);
+                    if (inside && random.FRand() < 0.35f)
+                    {
+                        GridPipe gridPipe = {};
+                        gridPipe.currentLocation = coord;
+                        gridPipe.currentPipeClass = random.RandRange(0, 7);
+
+                        storage[coord] = gridPipe;
+                        hashed[coord] = gridPipe;
+                    }
+                }
+            }
+        }
+
+        // Visit the probes in a scattered order, the way gaze and neighbor lookups do
+        for (int32 i = static_cast<int32>(probes.size()) - 1; i > 0; i--)
+        {
+            std::swap(probes[i], probes[random.RandRange(0, i)]);
+        }
+
+        test.TestEqual(L"Pipes stored", static_cast<int32>(storage.size()), static_cast<int32>(hashed.size()));
+
+        int32 mismatches = 0;
+        for (const FPipeGridCoordinate& probe : probes)
+        {
+            auto itStorage = storage.find(probe);
+            auto itHashed = hashed.find(probe);
+
+            const bool inStorage = (itStorage != storage.end());
+            const bool inHashed = (itHashed != hashed.end());
+
+            if (inStorage != inHashed ||
+                (inStorage && (itStorage->second.currentLocation != probe || itStorage->second.currentPipeClass != itHashed->second.currentPipeClass)))
+            {
+                if (mismatches < 10)
+                {
+                    test.AddError(FString::Printf(L"Grid of size %d disagrees at {%d, %d, %d}", playableGridSize, probe.X, probe.Y, probe.Z));
+                }
+
+                mismatches++;
+            }
+        }
+
+        test.AddInfo(FString::Printf(L"%d pipes in a grid of size %d, %d probes, %d iterations, %d bricks (%d KB of index)",
+            static_cast<int32>(storage.size()), playableGridSize, static_cast<int32>(probes.size()), iterations,
+            static_cast<int32>(storage.brick_count()), static_cast<int32>((storage.brick_count() * PipeGridStorage<GridPipe>::BrickCells * sizeof(int32)) / 1024)));
+
+        TimeGridStorage(test, L"Hashed map", hashed, probes, iterations);
+        TimeGridStorage(test, L"Grid storage", storage, probes, iterations);
+    }
+
+    // ---- Grids in a world ----
+
+    // The game mode's PipeGridClass, so the pipes it spawns are the game's
+    const TCHAR* const GridClassPath = L"/Game/Blueprints/BP_PipeGrid.BP_PipeGrid_C";
+
+    // A bare world holding one grid, as the InteractionReplay commandlet makes. Nothing ticks it, so
+    // tests drive the grid directly
+    class GridTestWorld
+    {
+    public:
+
+        GridTestWorld()
+        {
+            UClass* gridClass = LoadClass<APPipeGrid>(nullptr, GridClassPath);
+
+            m_world = UWorld::CreateWorld(EWorldType::Game, false);
+            FWorldContext& context = GEngine->CreateNewWorldContext(EWorldType::Game);
+            context.SetCurrentWorld(m_world);
+            m_world->InitializeActorsForPlay(FURL());
+
+            Grid = gridClass ? m_world->SpawnActor<APPipeGrid>(gridClass) : nullptr;
+        }
+
+        ~GridTestWorld()
+        {
+            GEngine->DestroyWorldContext(m_world);
+            m_world->DestroyWorld(false);
+        }
+
+        APPipeGrid* Grid = nullptr;
+
+    private:
+
+        UWorld* m_world = nullptr;
+    };
+
+    // ---- Incremental resolve ----
+
+    PipeDirections RandomlyRotated(PipeDirections connections, FRandomStream& random)
+    {
+        FRotator rotation(random.RandRange(0, 3) * 90.0f, random.RandRange(0, 3) * 90.0f, random.RandRange(0, 3) * 90.0f);
+        return RotateConnections(connections, rotation);
+    }
+
+    // ---- Gaze intersection ----
+
+    constexpr int VectorDimCount = 3;
+
+    enum class Quadrant
+    {
+        Right,
+        Left,
+        Middle
+    };
+
+    // What GazeIntersectsAABB used to be. Adapted from "Fast Ray-Box Intersection" by Andrew Woo -
+    // "Graphics Gems", Academic Press, 1990
+    bool WooIntersectsAABB(const FGazeUpdate& gaze, const FVector& minAABB, const FVector& maxAABB, FVector* position)
+    {
+        bool intersects = false;
+        FVector candidatePosition = { 0,0,0 };
+
+        bool inside = true;
+        Quadrant quadrant[VectorDimCount] = {};
+        float candidatePlane[VectorDimCount] = {};
+
+        // Find candidate planes
+        for (int i = 0; i < VectorDimCount; i++)
+        {
+            if (gaze.Origin[i] < minAABB[i])
+            {
+                quadrant[i] = Quadrant::Left;
+                candidatePlane[i] = minAABB[i];
+                inside = false;
+            }
+            else if (gaze.Origin[i] > maxAABB[i])
+            {
+                quadrant[i] = Quadrant::Right;
+                candidatePlane[i] = maxAABB[i];
+                inside = false;
+            }
+            else
+            {
+                quadrant[i] = Quadrant::Middle;
+                candidatePlane[i] = 0;
+            }
+        }
+
+        if (inside)
+        {
+            candidatePosition = gaze.Origin;
+            intersects = true;
+        }
+        else
+        {
+            // Calculate T distances to candidate planes
+            float maxT[VectorDimCount] = {};
+            for (int i = 0; i < VectorDimCount; i++)
+            {
+                if (quadrant[i] != Quadrant::Middle && gaze.Direction[i] != 0)
+                {
+                    maxT[i] = (candidatePlane[i] - gaze.Origin[i]) / gaze.Direction[i];
+                }
+                else
+                {
+                    maxT[i] = -1.0f;
+                }
+            }
+
+            // Get the largest of the maxT's for the final choice of intersection
+            int maxPlane = 0;
+            for (int i = 1; i < VectorDimCount; i++)
+            {
+                if (maxT[maxPlane] < maxT[i])
+                {
+                    maxPlane = i;
+                }
+            }
+
+            // Check final candidate actually inside box
+            if (maxT[maxPlane] >= 0)
+            {
+                intersects = true;
+                for (int i = 0; intersects && i < VectorDimCount; i++)
+                {
+                    if (maxPlane == i)
+                    {
+                        candidatePosition[i] = candidatePlane[i];
+                    }
+                    else
+                    {
+                        float pos = gaze.Origin[i] + (maxT[maxPlane] * gaze.Direction[i]);
+                        if (pos < minAABB[i] || pos > maxAABB[i])
+                        {
+                            intersects = false;
+                        }
+                        else
+                        {
+                            candidatePosition[i] = pos;
+                        }
+                    }
+                }
+            }
+        }
+
+        (*position) = intersects ? candidatePosition : FVector(0, 0, 0);
+        return intersects;
+    }
+
+    // Whether two answers agree, allowing for rounding
+    bool GazeHitsAgree(const FVector& minAABB, const FVector& maxAABB, bool lhsHit, const FVector& lhsPosition, bool rhsHit, const FVector& rhsPosition)
+    {
+        constexpr float Tolerance = 1e-3f;
+
+        if (lhsHit != rhsHit)
+        {
+            // Only acceptable if the ray just clips an edge of the box, where rounding can go either way
+            const FVector& position = lhsHit ? lhsPosition : rhsPosition;
+            int edgeAxes = 0;
+            for (int i = 0; i < VectorDimCount; i++)
+            {
+                if (FMath::IsNearlyEqual(position[i], minAABB[i], Tolerance) || FMath::IsNearlyEqual(position[i], maxAABB[i], Tolerance))
+                {
+                    edgeAxes++;
+                }
+            }
+
+            return (edgeAxes >= 2);
+        }
+
+        return (!lhsHit || lhsPosition.Equals(rhsPosition, Tolerance * FMath::Max(1.0f, lhsPosition.GetAbsMax())));
+    }
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPipeGridStorageTest, "HoloPipes.Grid.Storage", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FPipeGridStorageTest::RunTest(const FString& parameters)
+{
+    // The game's largest play space, and one big enough to need many bricks
+    CheckGridStorage(*this, 8, 200);
+    CheckGridStorage(*this, 32, 10);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPipeGridTransformTest, "HoloPipes.Grid.Transform", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FPipeGridTransformTest::RunTest(const FString& parameters)
+{
+    GridTestWorld world;
+    if (!world.Grid)
+    {
+        AddError(FString::Printf(L"Unable to spawn %s", GridClassPath));
+        return false;
+    }
+
+    APPipeGrid& grid = *world.Grid;
+
+    // The cached transforms have to follow every way the grid can be moved, once they've been read
+    const FTransform placed(FRotator(10.0f, 45.0f, 0.0f), FVector(30.0f, -20.0f, 100.0f), FVector(0.5f));
+    const FVector worldLocation(12.0f, 34.0f, 56.0f);
+
+    grid.GetWorldToGrid();
+    grid.SetActorTransform(placed);
+
+    TestTrue(L"Grid to world follows SetActorTransform", grid.GetGridToWorld().Equals(placed));
+    TestTrue(L"World to grid follows SetActorTransform", grid.GetWorldToGrid().Equals(placed.Inverse()));
+    TestTrue(L"World locations follow SetActorTransform",
+        grid.WorldLocationToGridLocation(worldLocation).Equals(placed.InverseTransformPosition(worldLocation), 1e-3f));
+
+    grid.SetActorLocation(FVector(-50.0f, 0.0f, 0.0f));
+    TestTrue(L"World to grid follows SetActorLocation", grid.GetWorldToGrid().Equals(grid.GetActorTransform().Inverse()));
+
+    grid.SetActorScale3D(FVector(2.0f));
+    TestTrue(L"World to grid follows SetActorScale3D", grid.GetWorldToGrid().Equals(grid.GetActorTransform().Inverse()));
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPipeGridIncrementalResolveTest, "HoloPipes.Grid.IncrementalResolve", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FPipeGridIncrementalResolveTest::RunTest(const FString& parameters)
+{
+    GridTestWorld world;
+    if (!world.Grid || !world.Grid->PipeClass)
+    {
+        AddError(FString::Printf(L"Unable to spawn %s with a pipe class", GridClassPath));
+        return false;
+    }
+
+    APPipeGrid& grid = *world.Grid;
+
+    // What the resolve decided for each connectivity node, in storage order
+    auto resolved = [&grid]()
+    {
+        std::vector<std::pair<int32, int32>> result;
+        for (const auto& entry : grid.m_pipesGrid)
+        {
+            if (grid.IsConnectivityNode(entry.second))
+            {
+                result.push_back({ entry.second.currentPipeClass, entry.second.openConnections });
+            }
+        }
+
+        return result;
+    };
+
+    // Fills the grid with random pipes, then places, removes and rotates them at random, checking the
+    // incremental resolve against a full one after each step. With async, the full resolve the worker
+    // threads make (see AsyncResolveJob) also has to agree with the incremental one
+    auto stress = [this, &grid, &resolved](int32 playableGridSize, int32 steps, bool async)
+    {
+        grid.AsyncResolveMinPipes = async ? 1 : 0;
+
+        grid.Clear();
+
+        FRandomStream random(playableGridSize * 7919 + steps);
+        const int gridMin = -(playableGridSize / 2);
+        const int gridMax = gridMin + playableGridSize - 1;
+
+        bool agree = true;
+        int32 step = 0;
+
+        for (; agree && step < steps; step++)
+        {
+            FPipeGridCoordinate coordinate = { random.RandRange(gridMin, gridMax), random.RandRange(gridMin, gridMax), random.RandRange(gridMin, gridMax) };
+            auto it = grid.m_pipesGrid.find(coordinate);
+            int action = random.RandRange(0, 2);
+
+            if (it == grid.m_pipesGrid.end() || action == 0)
+            {
+                // Place a random pipe, replacing whatever is there. Starts and ends are fixed like they
+                // are in generated levels, and a handful of classes makes groups with several likely
+                static const EPipeType Types[] = { EPipeType::Start, EPipeType::End, EPipeType::Straight, EPipeType::Straight, EPipeType::Corner, EPipeType::Corner, EPipeType::Junction, EPipeType::Block };
+
+                PipeSegmentGenerated segment = {};
+                segment.Type = Types[random.RandRange(0, ARRAYSIZE(Types) - 1)];
+                segment.Location = coordinate;
+
+                AddPipeOptions options = AddPipeOptions::None;
+
+                switch (segment.Type)
+                {
+                    case EPipeType::Start:
+                    case EPipeType::End:
+                        segment.PipeClass = random.RandRange(1, 3);
+                        segment.Connections = RandomlyRotated(PipeDirections::Top, random);
+                        options = AddPipeOptions::Fixed;
+                        break;
+
+                    case EPipeType::Straight:
+                        segment.Connections = RandomlyRotated(PipeDirections::Left | PipeDirections::Right, random);
+                        break;
+
+                    case EPipeType::Corner:
+                        segment.Connections = RandomlyRotated(PipeDirections::Top | PipeDirections::Right, random);
+                        break;
+
+                    case EPipeType::Junction:
+                        segment.Connections = RandomlyRotated(PipeDirections::Left | PipeDirections::Right | PipeDirections::Top, random);
+                        break;
+
+                    default:
+                        options = AddPipeOptions::Fixed;
+                        break;
+                }
+
+                grid.AddPipe(segment, options);
+            }
+            else if (action == 1)
+            {
+                grid.MarkConnectivityDirty(coordinate);
+
+                grid.ReleasePipe(it->second.pipe);
+                grid.EraseGridPipe(it);
+            }
+            else if (grid.IsConnectivityNode(it->second))
+            {
+                // Blocks can't be rotated
+                grid.MarkConnectivityDirty(coordinate);
+                it->second.pipe->SetPipeDirections(RandomlyRotated(it->second.pipe->GetPipeDirections(), random));
+            }
+
+            grid.ResolveGridChanges();
+            agree = grid.VerifyIncrementalResolve() && grid.VerifyPipeSets();
+
+            if (agree && async)
+            {
+                const std::vector<std::pair<int32, int32>> incremental = resolved();
+
+                grid.ResolveGridStateAsync();
+                grid.UpdateAsyncResolve(true /* wait */);
+
+                agree = (resolved() == incremental);
+            }
+        }
+
+        // The grid logs the details of whatever disagreed with a full resolve on the game thread
+        TestTrue(FString::Printf(L"%s resolve agrees on a grid of size %d (%d of %d steps, %d pipes)",
+            (async ? L"Async" : L"Incremental"), playableGridSize, step, steps, static_cast<int32>(grid.m_pipesGrid.size())), agree);
+
+        grid.Clear();
+    };
+
+    stress(3, 2000, false);
+    stress(8, 5000, false);
+
+    // Again, resolving the whole grid on worker threads after every step
+    stress(3, 1000, true);
+    stress(8, 1000, true);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPipeGridGazeIntersectionTest, "HoloPipes.Grid.GazeIntersection", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FPipeGridGazeIntersectionTest::RunTest(const FString& parameters)
+{
+    GridTestWorld world;
+    if (!world.Grid)
+    {
+        AddError(FString::Printf(L"Unable to spawn %s", GridClassPath));
+        return false;
+    }
+
+    APPipeGrid& grid = *world.Grid;
+
+    // Casts random rays at random boxes, checking the batched gaze test against the scalar one and
+    // the Graphics Gems routine it replaced, then times each
+    auto check = [this, &grid](int32 boxCount, int32 iterations)
+    {
+        FRandomStream random(boxCount);
+
+        // Boxes about the size of a gutter, scattered over a space about the size of a large level
+        std::vector<FVector> minAABBs(boxCount);
+        std::vector<FVector> maxAABBs(boxCount);
+
+        for (int32 i = 0; i < boxCount; i++)
+        {
+            const FVector center = FVector(random.FRandRange(-50.0f, 50.0f), random.FRandRange(-50.0f, 50.0f), random.FRandRange(-50.0f, 50.0f));
+            const FVector halfSize = FVector(random.FRandRange(0.5f, 5.0f), random.FRandRange(0.5f, 5.0f), random.FRandRange(0.5f, 5.0f));
+
+            minAABBs[i] = center - halfSize;
+            maxAABBs[i] = center + halfSize;
+        }
+
+        // Every ray heads for somewhere near one of the boxes, so there's a useful mix of hits and misses.
+        // Some start inside a box, and some run parallel to an axis, since those are the special cases
+        std::vector<FGazeUpdate> rays(iterations);
+        for (int32 i = 0; i < iterations; i++)
+        {
+            FGazeUpdate& ray = rays[i];
+
+            const int32 kind = i % 4;
+            const int32 box = random.RandRange(0, boxCount - 1);
+            const FVector target = (minAABBs[box] + maxAABBs[box]) / 2.0f + random.VRand() * random.FRandRange(0.0f, 6.0f);
+
+            ray.Origin = (kind == 1) ? target : random.VRand() * random.FRandRange(60.0f, 120.0f);
+            ray.Direction = (kind == 1) ? random.VRand() : (target - ray.Origin);
+
+            if (kind == 2)
+            {
+                ray.Direction[random.RandRange(0, VectorDimCount - 1)] = 0.0f;
+            }
+
+            ray.Direction = ray.Direction.GetSafeNormal();
+            if (ray.Direction.IsZero())
+            {
+                ray.Direction = FVector(1, 0, 0);
+            }
+        }
+
+        // Check that all three agree
+        int64 checks = 0;
+        int64 hits = 0;
+        int64 mismatches = 0;
+
+        FVector positions[APPipeGrid::GazeBatchSize];
+        for (const FGazeUpdate& ray : rays)
+        {
+            grid.m_gaze = ray;
+
+            for (int32 first = 0; first < boxCount; first += APPipeGrid::GazeBatchSize)
+            {
+                const int32 count = FMath::Min(APPipeGrid::GazeBatchSize, boxCount - first);
+                const uint32 batchHits = grid.GazeIntersectsAABBs(&minAABBs[first], &maxAABBs[first], count, positions);
+
+                for (int32 i = 0; i < count; i++)
+                {
+                    const FVector& minAABB = minAABBs[first + i];
+                    const FVector& maxAABB = maxAABBs[first + i];
+
+                    FVector wooPosition;
+                    const bool wooHit = WooIntersectsAABB(ray, minAABB, maxAABB, &wooPosition);
+
+                    FVector scalarPosition;
+                    const bool scalarHit = grid.GazeIntersectsAABB(minAABB, maxAABB, &scalarPosition);
+
+                    const bool batchHit = (batchHits & (1u << i)) != 0;
+
+                    if (!GazeHitsAgree(minAABB, maxAABB, wooHit, wooPosition, scalarHit, scalarPosition) ||
+                        !GazeHitsAgree(minAABB, maxAABB, scalarHit, scalarPosition, batchHit, positions[i]))
+                    {
+                        if (mismatches < 10)
+                        {
+                            AddError(FString::Printf(L"Mismatch for ray %s -> %s and box %s - %s: Woo %d %s, scalar %d %s, batched %d %s",
+                                *ray.Origin.ToString(), *ray.Direction.ToString(), *minAABB.ToString(), *maxAABB.ToString(),
+                                wooHit, *wooPosition.ToString(), scalarHit, *scalarPosition.ToString(), batchHit, *positions[i].ToString()));
+                        }
+
+                        mismatches++;
+                    }
+
+                    hits += (scalarHit ? 1 : 0);
+                    checks++;
+                }
+            }
+        }
+
+        // Then time them. Sum the positions so the loops can't be skipped
+        FVector checksum = FVector::ZeroVector;
+        FVector position;
+
+        double start = FPlatformTime::Seconds();
+        for (const FGazeUpdate& ray : rays)
+        {
+            for (int32 i = 0; i < boxCount; i++)
+            {
+                WooIntersectsAABB(ray, minAABBs[i], maxAABBs[i], &position);
+                checksum += position;
+            }
+        }
+        const double wooSeconds = FPlatformTime::Seconds() - start;
+
+        start = FPlatformTime::Seconds();
+        for (const FGazeUpdate& ray : rays)
+        {
+            grid.m_gaze = ray;
+            for (int32 i = 0; i < boxCount; i++)
+            {
+                grid.GazeIntersectsAABB(minAABBs[i], maxAABBs[i], &position);
+                checksum += position;
+            }
+        }
+        const double scalarSeconds = FPlatformTime::Seconds() - start;
+
+        start = FPlatformTime::Seconds();
+        for (const FGazeUpdate& ray : rays)
+        {
+            grid.m_gaze = ray;
+            for (int32 first = 0; first < boxCount; first += APPipeGrid::GazeBatchSize)
+            {
+                const int32 count = FMath::Min(APPipeGrid::GazeBatchSize, boxCount - first);
+                grid.GazeIntersectsAABBs(&minAABBs[first], &maxAABBs[first], count, positions);
+                checksum += positions[0];
+            }
+        }
+        const double batchSeconds = FPlatformTime::Seconds() - start;
+
+        const double tests = static_cast<double>(checks);
+        AddInfo(FString::Printf(L"%d boxes: %lld tests, %lld hits, %lld mismatches", boxCount, checks, hits, mismatches));
+        AddInfo(FString::Printf(L"Woo: %.2f ns, scalar slab: %.2f ns, batched slab: %.2f ns per box (checksum %s)",
+            (wooSeconds * 1e9) / tests, (scalarSeconds * 1e9) / tests, (batchSeconds * 1e9) / tests, *checksum.ToString()));
+    };
+
+    // A count that isn't a multiple of the batch size, so the last batch is a partial one
+    check(1023, 2000);
+
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPipeGridJournalTest, "HoloPipes.Grid.Journal", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FPipeGridJournalTest::RunTest(const FString& parameters)
+{
+    GridTestWorld world;
+    if (!world.Grid)
+    {
+        AddError(FString::Printf(L"Unable to spawn %s", GridClassPath));
+        return false;
+    }
+
+    APPipeGrid& grid = *world.Grid;
+
+    // A level with a toolbox, built as the game builds it
+    InteractionLogHeader header;
+    GetMutableDefault<APPipesGameMode>()->BuildOptionsForLevel(3, header.Options);
+
+    LevelGenerator generator;
+    if (!generator.GenerateLevelSync(header.Options))
+    {
+        AddError(FString::Printf(L"Unable to generate level %d", header.Options.Level));
+        return false;
+    }
+
+    header.Fingerprint = generator.GetFingerprint();
+
+    if (!grid.RebuildRecordedLevel(header) || !grid.Toolbox)
+    {
+        AddError(L"Unable to build the level with a toolbox");
+        return false;
+    }
+
+    grid.FinishPopulation();
+    grid.SetInteractionEnabled(true);
+
+    // The player's pipes, in a stable order, so the grid can be compared before and after
+    auto placed = [&grid]()
+    {
+        std::vector<std::pair<size_t, FString>> pipes;
+        for (const auto& entry : grid.m_pipesGrid)
+        {
+            const APPipe* pipe = entry.second.pipe;
+            if (pipe && !pipe->GetPipeFixed() && !pipe->GetInToolbox())
+            {
+                pipes.push_back({ FPipeGridCoordinate::HashOf(entry.first), FString::Printf(L"{%d, %d, %d} %d %d",
+                    entry.first.X, entry.first.Y, entry.first.Z, static_cast<int32>(pipe->GetPipeType()), static_cast<int32>(pipe->GetPipeDirections())) });
+            }
+        }
+
+        std::sort(pipes.begin(), pipes.end(), [](const auto& lhs, const auto& rhs) { return lhs.first < rhs.first; });
+
+        FString result;
+        for (const auto& pipe : pipes)
+        {
+            result += pipe.second + L"; ";
+        }
+
+        return result;
+    };
+
+    // Free cells in the play space to put pipes in
+    std::vector<FPipeGridCoordinate> freeCells;
+    const int playableMin = -(header.Options.PlaySpaceSize / 2);
+    const int playableMax = playableMin + header.Options.PlaySpaceSize - 1;
+
+    for (int z = playableMin; z <= playableMax && freeCells.size() < 4; z++)
+    {
+        for (int y = playableMin; y <= playableMax && freeCells.size() < 4; y++)
+        {
+            for (int x = playableMin; x <= playableMax && freeCells.size() < 4; x++)
+            {
+                if (grid.m_pipesGrid.find({ x, y, z }) == grid.m_pipesGrid.end())
+                {
+                    freeCells.push_back({ x, y, z });
+                }
+            }
+        }
+    }
+
+    EPipeType type = EPipeType::None;
+    for (EPipeType candidate : { EPipeType::Straight, EPipeType::Corner, EPipeType::Junction })
+    {
+        if (grid.Toolbox->CountRemaining(candidate) >= 2)
+        {
+            type = candidate;
+            break;
+        }
+    }
+
+    if (freeCells.size() < 4 || type == EPipeType::None)
+    {
+        AddError(L"The level has no room, or no toolbox pipes, to test with");
+        return false;
+    }
+
+    // Changes are made the way the player's drags and rotates make them, then journaled
+    auto change = [this, &grid](GridJournalEntry entry)
+    {
+        const bool applied = grid.ApplyJournalEntry(entry, false /* undo */);
+        TestTrue(L"Change applied", applied);
+
+        if (applied)
+        {
+            grid.JournalChange(entry);
+        }
+    };
+
+    const PipeDirections directions = PipeDirections::Left | PipeDirections::Right;
+    const PipeDirections rotated = PipeDirections::Top | PipeDirections::Bottom;
+
+    std::vector<FString> states = { placed() };
+
+    GridJournalEntry take;
+    take.Op = GridJournalOp::Take;
+    take.Scored = true;
+    take.Type = type;
+    take.To = freeCells[0];
+    take.DirectionsAfter = directions;
+    change(take);
+    states.push_back(placed());
+
+    GridJournalEntry rotate;
+    rotate.Op = GridJournalOp::Move;
+    rotate.Type = type;
+    rotate.From = freeCells[0];
+    rotate.To = freeCells[0];
+    rotate.DirectionsBefore = directions;
+    rotate.DirectionsAfter = rotated;
+    change(rotate);
+    states.push_back(placed());
+
+    GridJournalEntry translate = rotate;
+    translate.Scored = true;
+    translate.To = freeCells[1];
+    translate.DirectionsBefore = rotated;
+    change(translate);
+    states.push_back(placed());
+
+    // Undo everything and redo it all again, checking the grid and the score along the way. The
+    // rotate wasn't scored, so only the take and the translate are refunded
+    grid.UndoScoring = EUndoScoring::Refund;
+    grid.m_score.CurrentScore = 10;
+
+    const int32 refundedScores[] = { 9, 9, 8 };
+    for (int32 i = 0; i < 3; i++)
+    {
+        TestTrue(FString::Printf(L"Undo %d", i + 1), grid.Undo());
+        TestEqual(FString::Printf(L"Grid after undo %d", i + 1), placed(), states[states.size() - 2 - i]);
+        TestEqual(FString::Printf(L"Refunded score after undo %d", i + 1), grid.m_score.CurrentScore, refundedScores[i]);
+    }
+
+    TestFalse(L"Nothing left to undo", grid.CanUndo());
+
+    for (int32 i = 0; i < 3; i++)
+    {
+        TestTrue(FString::Printf(L"Redo %d", i + 1), grid.Redo());
+        TestEqual(FString::Printf(L"Grid after redo %d", i + 1), placed(), states[i + 1]);
+    }
+
+    TestEqual(L"Refunded score after redoing everything", grid.m_score.CurrentScore, 10);
+    TestFalse(L"Nothing left to redo", grid.CanRedo());
+
+    grid.UndoScoring = EUndoScoring::Penalty;
+    grid.UndoScorePenalty = 3;
+    TestTrue(L"Undo with a penalty", grid.Undo());
+    TestEqual(L"Penalized score", grid.m_score.CurrentScore, 13);
+
+    grid.UndoScoring = EUndoScoring::Free;
+    TestTrue(L"Redo for free", grid.Redo());
+    TestEqual(L"Free score", grid.m_score.CurrentScore, 13);
+
+    // A sweep of two pipes into the toolbox is one change
+    GridJournalEntry takeSecond = take;
+    takeSecond.To = freeCells[2];
+    change(takeSecond);
+
+    const FString beforeSweep = placed();
+
+    GridJournalEntry returnFirst;
+    returnFirst.Op = GridJournalOp::Return;
+    returnFirst.Type = type;
+    returnFirst.From = freeCells[1];
+    returnFirst.DirectionsBefore = rotated;
+    change(returnFirst);
+
+    GridJournalEntry returnSecond = returnFirst;
+    returnSecond.Grouped = true;
+    returnSecond.From = freeCells[2];
+    returnSecond.DirectionsBefore = directions;
+    change(returnSecond);
+
+    const FString afterSweep = placed();
+
+    TestTrue(L"Undo the sweep", grid.Undo());
+    TestEqual(L"Grid after undoing the sweep", placed(), beforeSweep);
+
+    // If part of a group can't be redone, none of it is
+    grid.JournalReturnPipe(type, freeCells[2]);
+    const FString tampered = placed();
+
+    TestFalse(L"Redo refused on a grid that doesn't match", grid.Redo());
+    TestEqual(L"Grid after a refused redo", placed(), tampered);
+    TestFalse(L"Journal cleared after a refused redo", grid.CanUndo() || grid.CanRedo());
+    TestNotEqual(L"Sweep wasn't half redone", placed(), afterSweep);
+
+    grid.Clear();
+    return true;
+}
+
+IMPLEMENT_SIMPLE_AUTOMATION_TEST(FPipeGridReplayTest, "HoloPipes.Grid.Replay", EAutomationTestFlags::ApplicationContextMask | EAutomationTestFlags::ProductFilter)
+
+bool FPipeGridReplayTest::RunTest(const FString& parameters)
+{
+    GridTestWorld world;
+    if (!world.Grid)
+    {
+        AddError(FString::Printf(L"Unable to spawn %s", GridClassPath));
+        return false;
+    }
+
+    APPipeGrid& grid = *world.Grid;
+
+    FGenerateOptions options = {};
+    GetMutableDefault<APPipesGameMode>()->BuildOptionsForLevel(3, options);
+
+    LevelGenerator generator;
+    if (!generator.GenerateLevelSync(options))
+    {
+        AddError(FString::Printf(L"Unable to generate level %d", options.Level));
+        return false;
+    }
+
+    const FString directory = FPaths::Combine(FPaths::AutomationTransientDir(), L"HoloPipes");
+    const FString levelPath = FPaths::Combine(directory, L"Level.hpreplay");
+    const FString recordingPath = FPaths::Combine(directory, L"Recording.hpreplay");
+    const FString mismatchPath = FPaths::Combine(directory, L"Mismatch.hpreplay");
+
+    // A log with no input, which only rebuilds the level
+    InteractionLog levelLog;
+    levelLog.Header.Options = options;
+    levelLog.Header.Fingerprint = generator.GetFingerprint();
+    levelLog.Header.GridTransform = FTransform(FRotator(0.0f, 90.0f, 0.0f), FVector(100.0f, 0.0f, 50.0f));
+
+    InteractionRecord enabled;
+    enabled.Type = InteractionRecordType::Enabled;
+    enabled.Enabled = InteractionEnabledFlags::Interaction | InteractionEnabledFlags::Drag | InteractionEnabledFlags::Rotate;
+    levelLog.Records.push_back(enabled);
+
+    InteractionRecord moved;
+    moved.Type = InteractionRecordType::GridTransform;
+    moved.Time = 0.5f;
+    moved.GridTransform = FTransform(FVector(0.0f, 20.0f, 0.0f));
+    levelLog.Records.push_back(moved);
+
+    InteractionLog loaded;
+    if (!TestTrue(L"Log saved", levelLog.Save(levelPath)) || !TestTrue(L"Log loaded", loaded.Load(levelPath)))
+    {
+        return false;
+    }
+
+    TestEqual(L"Level round trips", loaded.Header.Options.Level, options.Level);
+    TestEqual(L"Play space size round trips", loaded.Header.Options.PlaySpaceSize, options.PlaySpaceSize);
+    TestTrue(L"Fingerprint round trips", loaded.Header.Fingerprint == levelLog.Header.Fingerprint);
+    TestTrue(L"Grid transform round trips", loaded.Header.GridTransform.Equals(levelLog.Header.GridTransform, 0.0f));
+
+    if (TestEqual(L"Record count round trips", static_cast<int32>(loaded.Records.size()), static_cast<int32>(levelLog.Records.size())))
+    {
+        TestTrue(L"Enabled record round trips", loaded.Records[0].Type == InteractionRecordType::Enabled && loaded.Records[0].Enabled == enabled.Enabled);
+        TestTrue(L"Transform record round trips", loaded.Records[1].Type == InteractionRecordType::GridTransform &&
+            loaded.Records[1].Time == moved.Time && loaded.Records[1].GridTransform.Equals(moved.GridTransform, 0.0f));
+    }
+
+    if (!TestTrue(L"Replays the level it was recorded on", grid.ReplayInput(levelPath, FString())))
+    {
+        return false;
+    }
+
+    TestTrue(L"Replay rebuilt the level", grid.m_pipesGrid.size() > 0);
+    TestTrue(L"Replay moved the grid", grid.GetActorTransform().Equals(moved.GridTransform));
+    TestTrue(L"Replay moved the grid's cached transform", grid.GetWorldToGrid().Equals(moved.GridTransform.Inverse()));
+
+    // Record some gaze over the rebuilt level, and replay that
+    grid.FinishPopulation();
+
+    if (TestTrue(L"Recording started", grid.StartInputRecording(options, false /* buildSolution */, generator.GetFingerprint())))
+    {
+        constexpr int32 GazeCount = 30;
+        for (int32 i = 0; i < GazeCount; i++)
+        {
+            FGazeUpdate gaze = {};
+            gaze.Origin = FVector(-200.0f, 0.0f, 0.0f);
+            gaze.Direction = FRotator(0.0f, static_cast<float>(i - GazeCount / 2), 0.0f).Vector();
+
+            grid.HandlePawnGazeUpdate(gaze);
+        }
+
+        InteractionLog recorded;
+        if (TestTrue(L"Recording saved", grid.StopInputRecording(recordingPath)) && TestTrue(L"Recording loaded", recorded.Load(recordingPath)))
+        {
+            const int32 gazeRecords = static_cast<int32>(std::count_if(recorded.Records.begin(), recorded.Records.end(), [](const InteractionRecord& record)
+            {
+                return record.Type == InteractionRecordType::Gaze;
+            }));
+
+            TestEqual(L"Recorded every gaze", gazeRecords, GazeCount);
+            TestTrue(L"Replays a recording", grid.ReplayInput(recordingPath, FString()));
+        }
+    }
+
+    // Input recorded on another level would do something else entirely
+    InteractionLog mismatchLog = levelLog;
+    mismatchLog.Header.Fingerprint.Low ^= 1;
+
+    if (TestTrue(L"Mismatched log saved", mismatchLog.Save(mismatchPath)))
+    {
+        AddExpectedError(L"generated as", EAutomationExpectedErrorFlags::Contains, 1);
+        TestFalse(L"Refuses a log recorded on another level", grid.ReplayInput(mismatchPath, FString()));
+    }
+
+    TestFalse(L"Refuses a log that isn't there", loaded.Load(FPaths::Combine(directory, L"Missing.hpreplay")));
+
+    grid.Clear();
+    return true;
+}
+
+#endif
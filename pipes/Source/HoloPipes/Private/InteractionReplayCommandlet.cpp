@@ -0,0 +1,69 @@
+#include "InteractionReplayCommandlet.h"
+#include "PPipeGrid.h"
+#include "Engine/Engine.h"
+#include "Engine/World.h"
+#include "Misc/Parse.h"
+
+UInteractionReplayCommandlet::UInteractionReplayCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 UInteractionReplayCommandlet::Main(const FString& params)
+{
+    FString filePath;
+    FString gridPath;
+    FString csvPath;
+    int32 repeat = 1;
+
+    FParse::Value(*params, L"File=", filePath);
+    FParse::Value(*params, L"Grid=", gridPath);
+    FParse::Value(*params, L"Csv=", csvPath);
+    FParse::Value(*params, L"Repeat=", repeat);
+
+    if (filePath.IsEmpty() || gridPath.IsEmpty())
+    {
+        UE_LOG(HoloPipesLog, Error, L"InteractionReplay - Specify the recording with -File= and the grid class with -Grid=");
+        return 1;
+    }
+
+    UClass* gridClass = LoadClass<APPipeGrid>(nullptr, *gridPath);
+    if (!gridClass)
+    {
+        UE_LOG(HoloPipesLog, Error, L"InteractionReplay - Unable to load grid %s", *gridPath);
+        return 1;
+    }
+
+    // A bare world for the grid and its pipes. Nothing ticks it, so the replay drives the grid directly
+    UWorld* world = UWorld::CreateWorld(EWorldType::Game, false);
+    FWorldContext& context = GEngine->CreateNewWorldContext(EWorldType::Game);
+    context.SetCurrentWorld(world);
+    world->InitializeActorsForPlay(FURL());
+
+    int32 result = 0;
+
+    APPipeGrid* grid = world->SpawnActor<APPipeGrid>(gridClass);
+    if (!grid)
+    {
+        UE_LOG(HoloPipesLog, Error, L"InteractionReplay - Unable to spawn grid %s", *gridPath);
+        result = 1;
+    }
+
+    for (int32 i = 0; (result == 0) && i < FMath::Max(1, repeat); i++)
+    {
+        // Only the last repeat is written out, once everything is warm
+        const bool last = (i == FMath::Max(1, repeat) - 1);
+        if (!grid->ReplayInput(filePath, last ? csvPath : FString()))
+        {
+            result = 1;
+        }
+    }
+
+    GEngine->DestroyWorldContext(world);
+    world->DestroyWorld(false);
+
+    return result;
+}
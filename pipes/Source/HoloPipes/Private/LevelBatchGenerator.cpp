@@ -0,0 +1,216 @@
+#include "LevelBatchGenerator.h"
+#include <HAL/PlatformTime.h>
+#include <HAL/PlatformProcess.h>
+#include <Misc/ScopeLock.h>
+#include <Misc/Optional.h>
+
+LevelBatchGenerator::LevelBatchGenerator(int32 maxWorkers, int32 memoryBudgetKB)
+{
+    m_memoryBudgetKB = static_cast<uint64>(std::max(memoryBudgetKB, 0));
+    m_jobsChanged = FPlatformProcess::GetSynchEventFromPool(false /* manual reset */);
+
+    int32 workerCount = maxWorkers;
+    if (workerCount <= 0)
+    {
+        workerCount = std::max(FPlatformMisc::NumberOfCoresIncludingHyperthreads(), 1);
+    }
+
+    m_workers.reserve(workerCount);
+    for (int32 i = 0; i < workerCount; i++)
+    {
+        std::unique_ptr<Worker> worker = std::make_unique<Worker>(*this);
+        worker->m_thread = FRunnableThread::Create(worker.get(), *FString::Printf(L"LevelBatchWorker%d", i), 0, TPri_Normal);
+
+        if (worker->m_thread)
+        {
+            m_workers.push_back(std::move(worker));
+        }
+        else
+        {
+            UE_LOG(HoloPipesLog, Error, L"LevelBatchGenerator - Unable to create worker thread %d", i);
+        }
+    }
+}
+
+LevelBatchGenerator::~LevelBatchGenerator()
+{
+    {
+        FScopeLock lock(&m_lock);
+        m_shutdown = true;
+    }
+
+    m_jobsChanged->Trigger();
+
+    // Workers stop picking up jobs once we're shutting down, so fail whatever is still queued
+    CancelPending();
+
+    for (auto& worker : m_workers)
+    {
+        worker->m_thread->WaitForCompletion();
+        delete worker->m_thread;
+        worker->m_thread = nullptr;
+    }
+
+    m_workers.clear();
+
+    FPlatformProcess::ReturnSynchEventToPool(m_jobsChanged);
+    m_jobsChanged = nullptr;
+}
+
+TFuture<GeneratedLevel> LevelBatchGenerator::GenerateLevel(const FGenerateOptions& options)
+{
+    TFuture<GeneratedLevel> result = QueueJob(options);
+    m_jobsChanged->Trigger();
+
+    return result;
+}
+
+std::vector<TFuture<GeneratedLevel>> LevelBatchGenerator::GenerateLevels(TArrayView<const FGenerateOptions> options)
+{
+    std::vector<TFuture<GeneratedLevel>> results;
+    results.reserve(options.Num());
+
+    for (const auto& levelOptions : options)
+    {
+        results.push_back(QueueJob(levelOptions));
+    }
+
+    // The first worker to wake passes it on to the rest
+    m_jobsChanged->Trigger();
+
+    return results;
+}
+
+TFuture<GeneratedLevel> LevelBatchGenerator::QueueJob(const FGenerateOptions& options)
+{
+    Job job;
+    job.Options = options;
+
+    // Nobody is consuming the stream, so don't fill it
+    job.Options.StreamPipes = false;
+
+    job.MemoryKB = LevelGenerator::EstimateMemoryKB(job.Options);
+
+    if (m_memoryBudgetKB > 0 && job.MemoryKB > m_memoryBudgetKB)
+    {
+        // This job could never be admitted as is, so make the generator fit it into the whole budget
+        job.Options.MemoryBudgetKB = static_cast<int32>(m_memoryBudgetKB);
+        job.MemoryKB = m_memoryBudgetKB;
+    }
+
+    TFuture<GeneratedLevel> result = job.Promise.GetFuture();
+
+    FScopeLock lock(&m_lock);
+    m_jobs.push_back(MoveTemp(job));
+
+    return result;
+}
+
+void LevelBatchGenerator::CancelPending()
+{
+    std::deque<Job> canceled;
+
+    {
+        FScopeLock lock(&m_lock);
+        canceled.swap(m_jobs);
+    }
+
+    for (auto& job : canceled)
+    {
+        GeneratedLevel result;
+        result.Options = job.Options;
+        job.Promise.SetValue(MoveTemp(result));
+    }
+}
+
+int32 LevelBatchGenerator::GetPendingCount()
+{
+    FScopeLock lock(&m_lock);
+    return static_cast<int32>(m_jobs.size());
+}
+
+bool LevelBatchGenerator::CanStartNextJob()
+{
+    // The next job in line has to fit in the budget. If nothing is running, it always fits
+    return !m_jobs.empty() &&
+           (m_memoryBudgetKB == 0 || m_memoryInUseKB == 0 || (m_memoryInUseKB + m_jobs.front().MemoryKB) <= m_memoryBudgetKB);
+}
+
+uint32 LevelBatchGenerator::Worker::Run()
+{
+    m_batch.RunWorker(m_generator);
+    return 0;
+}
+
+void LevelBatchGenerator::RunWorker(LevelGenerator& generator)
+{
+    while (true)
+    {
+        // Only set once a job is taken, since a promise has to be kept once it's made
+        TOptional<Job> job;
+        bool wakeAnother = false;
+
+        {
+            FScopeLock lock(&m_lock);
+
+            if (m_shutdown)
+            {
+                wakeAnother = true;
+            }
+            else if (CanStartNextJob())
+            {
+                job.Emplace(MoveTemp(m_jobs.front()));
+                m_jobs.pop_front();
+                m_memoryInUseKB += job->MemoryKB;
+
+                wakeAnother = CanStartNextJob();
+            }
+        }
+
+        if (wakeAnother)
+        {
+            m_jobsChanged->Trigger();
+        }
+
+        if (!job.IsSet())
+        {
+            if (wakeAnother)
+            {
+                // Shutting down
+                break;
+            }
+
+            m_jobsChanged->Wait();
+            continue;
+        }
+
+        GeneratedLevel result;
+        result.Options = job->Options;
+
+        const double start = FPlatformTime::Seconds();
+
+        result.Success = generator.GenerateLevelSync(job->Options);
+
+        result.GenerateSeconds = FPlatformTime::Seconds() - start;
+        result.ExpansionCount = generator.GetLastExpansionCount();
+
+        if (result.Success)
+        {
+            result.VirtualPipes = std::move(generator.VirtualPipes);
+            result.RealizedPipes = std::move(generator.RealizedPipes);
+            result.Fingerprint = generator.GetFingerprint();
+            result.ParScore = generator.GetParScore();
+            result.ParScoreExact = generator.GetParScoreExact();
+        }
+
+        {
+            FScopeLock lock(&m_lock);
+            m_memoryInUseKB -= job->MemoryKB;
+        }
+
+        // Freeing memory may let a waiting job in
+        m_jobsChanged->Trigger();
+
+        job->Promise.SetValue(MoveTemp(result));
+    }
+}
@@ -0,0 +1,130 @@
+#include "LevelFingerprintCommandlet.h"
+#include "PPipesGameMode.h"
+#include "LevelBatchGenerator.h"
+#include "Misc/Parse.h"
+#include "Misc/Paths.h"
+#include "Misc/FileHelper.h"
+#include "HAL/PlatformTime.h"
+
+ULevelFingerprintCommandlet::ULevelFingerprintCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 ULevelFingerprintCommandlet::Main(const FString& params)
+{
+    const bool write = FParse::Param(*params, L"Write");
+    const bool verify = FParse::Param(*params, L"Verify");
+
+    int32 firstLevel = 1;
+    int32 lastLevel = 1000;
+    int32 workers = 0;
+    FString filePath = FPaths::Combine(FPaths::ProjectDir(), L"Build", L"LevelFingerprints.csv");
+
+    FParse::Value(*params, L"FirstLevel=", firstLevel);
+    FParse::Value(*params, L"LastLevel=", lastLevel);
+    FParse::Value(*params, L"Workers=", workers);
+    FParse::Value(*params, L"File=", filePath);
+
+    if (write == verify)
+    {
+        UE_LOG(HoloPipesLog, Error, L"LevelFingerprint - Specify exactly one of -Write or -Verify");
+        return 1;
+    }
+
+    // When verifying, the table decides which levels we generate
+    std::vector<int32> levels;
+    std::vector<FString> expected;
+
+    if (verify)
+    {
+        TArray<FString> lines;
+        if (!FFileHelper::LoadFileToStringArray(lines, *filePath))
+        {
+            UE_LOG(HoloPipesLog, Error, L"LevelFingerprint - Unable to read %s. Write it with -Write from a build whose levels are known to be right", *filePath);
+            return 1;
+        }
+
+        for (const FString& line : lines)
+        {
+            FString level;
+            FString fingerprint;
+
+            if (line.Split(L",", &level, &fingerprint) && level.IsNumeric())
+            {
+                levels.push_back(FCString::Atoi(*level));
+                expected.push_back(fingerprint.TrimStartAndEnd());
+            }
+        }
+    }
+    else
+    {
+        for (int32 level = firstLevel; level <= lastLevel; level++)
+        {
+            levels.push_back(level);
+        }
+    }
+
+    if (levels.empty())
+    {
+        UE_LOG(HoloPipesLog, Error, L"LevelFingerprint - No levels to generate");
+        return 1;
+    }
+
+    APPipesGameMode* gameMode = GetMutableDefault<APPipesGameMode>();
+
+    std::vector<FGenerateOptions> options(levels.size());
+    for (size_t i = 0; i < levels.size(); i++)
+    {
+        gameMode->BuildOptionsForLevel(levels[i], options[i]);
+
+        // The fingerprint only covers the layout, so there's no point proving par scores
+        options[i].SolverBudgetMs = 0.0f;
+    }
+
+    const double start = FPlatformTime::Seconds();
+
+    LevelBatchGenerator batch(workers);
+    std::vector<TFuture<GeneratedLevel>> results = batch.GenerateLevels(TArrayView<const FGenerateOptions>(options.data(), options.size()));
+
+    FString table = L"Level,Fingerprint\n";
+    int32 mismatches = 0;
+
+    for (size_t i = 0; i < results.size(); i++)
+    {
+        const GeneratedLevel& generated = results[i].Get();
+
+        // Failing to generate is recorded too, since that's also something an optimization shouldn't change
+        const FString fingerprint = generated.Success ? generated.Fingerprint.ToString() : FString(L"Failed");
+
+        if (write)
+        {
+            table += FString::Printf(L"%d,%s\n", levels[i], *fingerprint);
+        }
+        else if (fingerprint != expected[i])
+        {
+            UE_LOG(HoloPipesLog, Error, L"LevelFingerprint - Level %d is %s, expected %s", levels[i], *fingerprint, *expected[i]);
+            mismatches++;
+        }
+    }
+
+    const double seconds = FPlatformTime::Seconds() - start;
+
+    if (write)
+    {
+        if (!FFileHelper::SaveStringToFile(table, *filePath))
+        {
+            UE_LOG(HoloPipesLog, Error, L"LevelFingerprint - Unable to write %s", *filePath);
+            return 1;
+        }
+
+        UE_LOG(HoloPipesLog, Display, L"LevelFingerprint - Wrote %d levels to %s in %.2f seconds", (int32)levels.size(), *filePath, seconds);
+        return 0;
+    }
+
+    UE_LOG(HoloPipesLog, Display, L"LevelFingerprint - Verified %d levels in %.2f seconds, %d mismatched", (int32)levels.size(), seconds, mismatches);
+    return (mismatches == 0) ? 0 : 1;
+}
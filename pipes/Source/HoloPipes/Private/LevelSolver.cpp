@@ -0,0 +1,476 @@
+
+#include "LevelSolver.h"
+#include <HAL/PlatformTime.h>
+
+// How many search nodes we visit between budget checks. Each node runs a handful of breadth
+// first searches, so reading the clock this often is noise in comparison
+static constexpr int64 BudgetCheckInterval = 8;
+
+static const EPipeType SolverPipeTypes[] = { EPipeType::Straight, EPipeType::Corner, EPipeType::Junction };
+
+const std::vector<LevelSolver::Orientation>& LevelSolver::GetOrientations()
+{
+    // Straights connect opposite sides, corners connect two perpendicular sides and junctions
+    // are a straight with one perpendicular branch (the T junction the generator builds). Built
+    // by a static initializer, since the batch and seed search workers all solve at once
+    static const std::vector<Orientation> orientations = []()
+    {
+        std::vector<Orientation> built;
+
+        for (int a = 0; a < APPipe::ValidDirectionsCount; a++)
+        {
+            for (int b = a + 1; b < APPipe::ValidDirectionsCount; b++)
+            {
+                const PipeDirections first = APPipe::ValidDirections[a];
+                const PipeDirections second = APPipe::ValidDirections[b];
+
+                if (APPipe::InvertPipeDirection(first) == second)
+                {
+                    built.push_back({ EPipeType::Straight, first | second });
+
+                    for (int c = 0; c < APPipe::ValidDirectionsCount; c++)
+                    {
+                        const PipeDirections branch = APPipe::ValidDirections[c];
+                        if (branch != first && branch != second)
+                        {
+                            built.push_back({ EPipeType::Junction, first | second | branch });
+                        }
+                    }
+                }
+                else
+                {
+                    built.push_back({ EPipeType::Corner, first | second });
+                }
+            }
+        }
+
+        return built;
+    }();
+
+    return orientations;
+}
+
+bool LevelSolver::Solve(
+    const std::vector<PipeSegmentGenerated>& realized,
+    const std::vector<PipeSegmentGenerated>& placeable,
+    int sideMin,
+    int sideMax,
+    float budgetMs,
+    int32& par)
+{
+    m_start = FPlatformTime::Seconds();
+    m_deadline = m_start + (budgetMs / 1000.0);
+    m_outOfBudget = false;
+    m_nodeCount = 0;
+
+    m_sideMin = sideMin;
+    m_sideMax = sideMax;
+    m_gridSide = (sideMax - sideMin) + 1;
+
+    // The generated layout places every toolbox pipe once, so it's always a solution
+    m_best = static_cast<int>(placeable.size());
+
+    bool exact = false;
+
+    std::vector<OpenStub> stubs;
+    if (budgetMs > 0.0f && m_gridSide > 0 && BuildStartState(realized, placeable, stubs))
+    {
+        Search(stubs, 0);
+        exact = !m_outOfBudget;
+    }
+
+    par = m_best;
+
+    m_cells.clear();
+    m_lastSolveSeconds = FPlatformTime::Seconds() - m_start;
+
+    return exact;
+}
+
+bool LevelSolver::BuildStartState(const std::vector<PipeSegmentGenerated>& realized, const std::vector<PipeSegmentGenerated>& placeable, std::vector<OpenStub>& stubs)
+{
+    const size_t cellCount = static_cast<size_t>(m_gridSide) * m_gridSide * m_gridSide;
+
+    m_cells.assign(cellCount, SolverCell());
+    m_fields.clear();
+    m_searchQueue.reserve(cellCount);
+
+    for (auto& count : m_inventory)
+    {
+        count = 0;
+    }
+
+    for (const auto& segment : placeable)
+    {
+        m_inventory[static_cast<int>(segment.Type)]++;
+    }
+
+    for (const auto& segment : realized)
+    {
+        if (!InGrid(segment.Location))
+        {
+            UE_LOG(HoloPipesLog, Warning, L"LevelSolver - Fixed segment outside the grid { %d, %d, %d }", segment.Location.X, segment.Location.Y, segment.Location.Z);
+            return false;
+        }
+
+        auto& cell = CellAt(segment.Location);
+        cell.Type = segment.Type;
+        cell.Connections = segment.Connections;
+        cell.PipeClass = segment.PipeClass;
+    }
+
+    // Every connection on a fixed pipe either meets a fixed neighbor that connects back, or
+    // is an open stub we need to close
+    for (const auto& segment : realized)
+    {
+        if (segment.Type == EPipeType::Block)
+        {
+            continue;
+        }
+
+        for (int i = 0; i < APPipe::ValidDirectionsCount; i++)
+        {
+            const PipeDirections direction = APPipe::ValidDirections[i];
+            if ((segment.Connections & direction) == PipeDirections::None)
+            {
+                continue;
+            }
+
+            const FPipeGridCoordinate target = segment.Location + APPipe::PipeDirectionToLocationAdjustment(direction);
+            const PipeDirections back = APPipe::InvertPipeDirection(direction);
+
+            if (!InPlaySpace(target) && !InGrid(target))
+            {
+                return false;
+            }
+
+            const auto& neighbor = CellAt(target);
+            if (neighbor.Type == EPipeType::None)
+            {
+                if (!InPlaySpace(target))
+                {
+                    return false;
+                }
+
+                stubs.push_back({ target, back, segment.PipeClass });
+            }
+            else if ((neighbor.Connections & back) == PipeDirections::None || neighbor.PipeClass != segment.PipeClass)
+            {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+void LevelSolver::Search(const std::vector<OpenStub>& stubs, int placed)
+{
+    m_nodeCount++;
+    if ((m_nodeCount % BudgetCheckInterval) == 0 && FPlatformTime::Seconds() > m_deadline)
+    {
+        m_outOfBudget = true;
+    }
+
+    if (m_outOfBudget)
+    {
+        return;
+    }
+
+    if (stubs.empty())
+    {
+        // Every connection is closed. We only get here when we beat the best so far
+        m_best = placed;
+        return;
+    }
+
+    const int lowerBound = LowerBound(stubs);
+    if (lowerBound < 0 || (placed + lowerBound) >= m_best)
+    {
+        return;
+    }
+
+    // Close the first stub. Any other stubs pointing at the same cell have to be satisfied by
+    // the same pipe, so gather them up front
+    const FPipeGridCoordinate target = stubs.front().Target;
+    const int pipeClass = stubs.front().PipeClass;
+
+    PipeDirections required = PipeDirections::None;
+    for (const auto& stub : stubs)
+    {
+        if (stub.Target == target)
+        {
+            if (stub.PipeClass != pipeClass)
+            {
+                // Two classes meet here, so there's no pipe that can go in this cell
+                return;
+            }
+
+            required |= stub.Back;
+        }
+    }
+
+    std::vector<OpenStub> nextStubs;
+    nextStubs.reserve(stubs.size() + 2);
+
+    for (const auto& orientation : GetOrientations())
+    {
+        if (m_inventory[static_cast<int>(orientation.Type)] <= 0 ||
+            (orientation.Connections & required) != required)
+        {
+            continue;
+        }
+
+        // Every connection we add beyond the required ones becomes a new stub, so it has to point
+        // at an empty cell in the play space
+        const PipeDirections added = orientation.Connections & ~required;
+        bool valid = true;
+
+        nextStubs.clear();
+        for (const auto& stub : stubs)
+        {
+            if (stub.Target != target)
+            {
+                nextStubs.push_back(stub);
+            }
+        }
+
+        for (int i = 0; valid && i < APPipe::ValidDirectionsCount; i++)
+        {
+            const PipeDirections direction = APPipe::ValidDirections[i];
+            if ((added & direction) != PipeDirections::None)
+            {
+                const FPipeGridCoordinate next = target + APPipe::PipeDirectionToLocationAdjustment(direction);
+                valid = InPlaySpace(next) && CellAt(next).Type == EPipeType::None;
+
+                if (valid)
+                {
+                    nextStubs.push_back({ next, APPipe::InvertPipeDirection(direction), pipeClass });
+                }
+            }
+        }
+
+        if (valid)
+        {
+            auto& cell = CellAt(target);
+            cell.Type = orientation.Type;
+            cell.Connections = orientation.Connections;
+            cell.PipeClass = pipeClass;
+            m_inventory[static_cast<int>(orientation.Type)]--;
+
+            Search(nextStubs, placed + 1);
+
+            m_inventory[static_cast<int>(orientation.Type)]++;
+            cell = SolverCell();
+
+            if (m_outOfBudget)
+            {
+                return;
+            }
+        }
+    }
+}
+
+int LevelSolver::LowerBound(const std::vector<OpenStub>& stubs)
+{
+    // Each class's stubs have to be closed by its own pipes, so the bound is the sum of the
+    // per-class bounds. A class with an odd number of stubs can't be closed by paths alone, so
+    // it needs at least one junction from the toolbox
+    int bound = 0;
+    int junctionsNeeded = 0;
+    int remainingPipes = 0;
+
+    for (const EPipeType type : SolverPipeTypes)
+    {
+        remainingPipes += m_inventory[static_cast<int>(type)];
+    }
+
+    for (int pipeClass = 0; pipeClass < PipeClassCount; pipeClass++)
+    {
+        m_classStubs.clear();
+        for (size_t i = 0; i < stubs.size(); i++)
+        {
+            if (stubs[i].PipeClass == pipeClass)
+            {
+                m_classStubs.push_back(static_cast<int>(i));
+            }
+        }
+
+        if (m_classStubs.empty())
+        {
+            continue;
+        }
+
+        const int classBound = ClassLowerBound(stubs, m_classStubs);
+        if (classBound < 0)
+        {
+            return -1;
+        }
+
+        bound += classBound;
+        junctionsNeeded += static_cast<int>(m_classStubs.size() % 2);
+    }
+
+    if (junctionsNeeded > m_inventory[static_cast<int>(EPipeType::Junction)] || bound > remainingPipes)
+    {
+        return -1;
+    }
+
+    return bound;
+}
+
+int LevelSolver::ClassLowerBound(const std::vector<OpenStub>& stubs, const std::vector<int>& classStubs)
+{
+    // A stub can never be closed on its own (there are no caps in the toolbox)
+    const size_t count = classStubs.size();
+    if (count < 2)
+    {
+        return -1;
+    }
+
+    if (m_fields.size() < count)
+    {
+        const size_t cellCount = m_cells.size();
+        m_fields.resize(count);
+        for (auto& field : m_fields)
+        {
+            if (field.Stamps.size() != cellCount)
+            {
+                field.Stamps.assign(cellCount, 0);
+                field.Distances.assign(cellCount, 0);
+                field.Stamp = 0;
+            }
+        }
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        FillDistances(stubs[classStubs[i]].Target, static_cast<int>(i));
+    }
+
+    if (count == 3)
+    {
+        // Three stubs are always closed by a single tree, which has some cell where the paths to
+        // each stub meet. The cheapest such meeting point gives the exact Steiner tree size
+        int best = -1;
+        for (size_t cell = 0; cell < m_cells.size(); cell++)
+        {
+            int total = 0;
+            for (int f = 0; f < 3 && total >= 0; f++)
+            {
+                const DistanceField& field = m_fields[f];
+                total = (field.Stamps[cell] == field.Stamp) ? total + field.Distances[cell] : -1;
+            }
+
+            if (total >= 0 && (best < 0 || total < best))
+            {
+                best = total;
+            }
+        }
+
+        return (best < 0) ? -1 : best + 1;
+    }
+
+    // Otherwise, the pipes closing the stubs form trees with the stubs' target cells as vertices.
+    // Walking a tree visits every target, and each step to the next target is at least the distance
+    // to the nearest one, so the trees have at least (sum of nearest distances / 2) edges, and at
+    // least one more cell than that. With exactly two stubs this is just the shortest path
+    int nearestTotal = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        int nearest = -1;
+        for (size_t j = 0; j < count; j++)
+        {
+            if (i != j)
+            {
+                const int distance = DistanceTo(stubs[classStubs[j]].Target, static_cast<int>(i));
+                if (distance >= 0 && (nearest < 0 || distance < nearest))
+                {
+                    nearest = distance;
+                }
+            }
+        }
+
+        if (nearest < 0)
+        {
+            return -1;
+        }
+
+        nearestTotal += nearest;
+    }
+
+    return ((nearestTotal + 1) / 2) + 1;
+}
+
+void LevelSolver::FillDistances(const FPipeGridCoordinate& from, int fieldIndex)
+{
+    // Breadth first search through the empty play space cells
+    DistanceField& field = m_fields[fieldIndex];
+    field.Stamp++;
+
+    m_searchQueue.clear();
+
+    const int startIndex = CellIndexOf(from);
+    field.Stamps[startIndex] = field.Stamp;
+    field.Distances[startIndex] = 0;
+    m_searchQueue.push_back(from);
+
+    for (size_t head = 0; head < m_searchQueue.size(); head++)
+    {
+        const FPipeGridCoordinate current = m_searchQueue[head];
+        const int nextDistance = field.Distances[CellIndexOf(current)] + 1;
+
+        for (int d = 0; d < APPipe::ValidDirectionsCount; d++)
+        {
+            const FPipeGridCoordinate next = current + APPipe::PipeDirectionToLocationAdjustment(APPipe::ValidDirections[d]);
+            if (!InPlaySpace(next))
+            {
+                continue;
+            }
+
+            const int nextIndex = CellIndexOf(next);
+            if (field.Stamps[nextIndex] != field.Stamp && m_cells[nextIndex].Type == EPipeType::None)
+            {
+                field.Stamps[nextIndex] = field.Stamp;
+                field.Distances[nextIndex] = nextDistance;
+                m_searchQueue.push_back(next);
+            }
+        }
+    }
+}
+
+int LevelSolver::DistanceTo(const FPipeGridCoordinate& location, int fieldIndex) const
+{
+    const DistanceField& field = m_fields[fieldIndex];
+    const int index = CellIndexOf(location);
+    return (field.Stamps[index] == field.Stamp) ? field.Distances[index] : -1;
+}
+
+bool LevelSolver::InGrid(const FPipeGridCoordinate& location) const
+{
+    return
+        location.X >= m_sideMin && location.X <= m_sideMax &&
+        location.Y >= m_sideMin && location.Y <= m_sideMax &&
+        location.Z >= m_sideMin && location.Z <= m_sideMax;
+}
+
+bool LevelSolver::InPlaySpace(const FPipeGridCoordinate& location) const
+{
+    return
+        location.X > m_sideMin && location.X < m_sideMax &&
+        location.Y > m_sideMin && location.Y < m_sideMax &&
+        location.Z > m_sideMin && location.Z < m_sideMax;
+}
+
+LevelSolver::SolverCell& LevelSolver::CellAt(const FPipeGridCoordinate& location)
+{
+    return m_cells[CellIndexOf(location)];
+}
+
+int LevelSolver::CellIndexOf(const FPipeGridCoordinate& location) const
+{
+    return
+        ((location.Z - m_sideMin) * m_gridSide * m_gridSide) +
+        ((location.X - m_sideMin) * m_gridSide) +
+        (location.Y - m_sideMin);
+}
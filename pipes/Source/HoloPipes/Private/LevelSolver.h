@@ -0,0 +1,106 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <vector>
+#include "PPipe.h"
+
+//
+// Computes the par score of a generated level: the fewest grasps (as counted by
+// APPipeGrid::ScoreHandGrasp) needed to take the level from its starting state to a
+// state ResolveGridState considers solved.
+//
+// Every grasp of a new toolbox pipe costs one point, and a single grasp can both move
+// and rotate the pipe, so the par score is the fewest toolbox pipes that close every
+// open connection on the fixed pipes without mixing classes. The solver runs a
+// depth-first branch and bound over the open connections, using the generated layout
+// as the initial upper bound and per-class shortest path / Steiner tree distances as
+// the lower bound. Placements are limited to the play space (the same cells the
+// generator routes through) and to the toolbox inventory.
+//
+// Small levels are usually proven in a few milliseconds. Large, crowded levels rarely
+// are, which is what the budget is for.
+//
+class LevelSolver
+{
+public:
+
+    // Returns true if par is exact. If the search runs out of budgetMs, par holds the best
+    // solution found so far and callers should fall back to their own heuristic
+    bool Solve(
+        const std::vector<PipeSegmentGenerated>& realized,
+        const std::vector<PipeSegmentGenerated>& placeable,
+        int sideMin,
+        int sideMax,
+        float budgetMs,
+        int32& par);
+
+    double GetLastSolveSeconds() const { return m_lastSolveSeconds; }
+    int64 GetLastNodeCount() const { return m_nodeCount; }
+
+private:
+
+    struct SolverCell
+    {
+        EPipeType Type = EPipeType::None;
+        PipeDirections Connections = PipeDirections::None;
+        int PipeClass = DefaultPipeClass;
+    };
+
+    // An open connection: a pipe at some cell connects toward Target, which is still empty.
+    // Whatever is placed at Target must connect back in direction Back and join PipeClass
+    struct OpenStub
+    {
+        FPipeGridCoordinate Target;
+        PipeDirections Back;
+        int PipeClass;
+    };
+
+    struct Orientation
+    {
+        EPipeType Type;
+        PipeDirections Connections;
+    };
+
+    bool BuildStartState(const std::vector<PipeSegmentGenerated>& realized, const std::vector<PipeSegmentGenerated>& placeable, std::vector<OpenStub>& stubs);
+    void Search(const std::vector<OpenStub>& stubs, int placed);
+    int LowerBound(const std::vector<OpenStub>& stubs);
+    int ClassLowerBound(const std::vector<OpenStub>& stubs, const std::vector<int>& classStubs);
+    void FillDistances(const FPipeGridCoordinate& from, int field);
+    int DistanceTo(const FPipeGridCoordinate& location, int field) const;
+
+    bool InGrid(const FPipeGridCoordinate& location) const;
+    bool InPlaySpace(const FPipeGridCoordinate& location) const;
+    SolverCell& CellAt(const FPipeGridCoordinate& location);
+    int CellIndexOf(const FPipeGridCoordinate& location) const;
+
+    static const std::vector<Orientation>& GetOrientations();
+
+    std::vector<SolverCell> m_cells;
+
+    // Breadth first search scratch space for the lower bound, one distance field per stub of the
+    // class being bounded. A field's distances are only valid where its stamp matches the field's
+    // current stamp, so we never have to clear them
+    struct DistanceField
+    {
+        std::vector<int> Stamps;
+        std::vector<int> Distances;
+        int Stamp = 0;
+    };
+
+    std::vector<DistanceField> m_fields;
+    std::vector<FPipeGridCoordinate> m_searchQueue;
+    std::vector<int> m_classStubs;
+    int m_inventory[static_cast<int>(EPipeType::Block) + 1] = {};
+
+    int m_sideMin = 0;
+    int m_sideMax = 0;
+    int m_gridSide = 0;
+
+    int m_best = 0;
+    bool m_outOfBudget = false;
+    int64 m_nodeCount = 0;
+
+    double m_start = 0.0;
+    double m_deadline = 0.0;
+    double m_lastSolveSeconds = 0.0;
+};
@@ -0,0 +1,86 @@
+#include "LevelSolverBenchmarkCommandlet.h"
+#include "PPipesGameMode.h"
+#include "LevelGenerator.h"
+#include "Misc/Parse.h"
+
+ULevelSolverBenchmarkCommandlet::ULevelSolverBenchmarkCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 ULevelSolverBenchmarkCommandlet::Main(const FString& params)
+{
+    int32 lastLevel = 100;
+    FString gameModePath;
+
+    FParse::Value(*params, L"LastLevel=", lastLevel);
+    FParse::Value(*params, L"GameMode=", gameModePath);
+
+    if (lastLevel < 1)
+    {
+        UE_LOG(HoloPipesLog, Error, L"LevelSolverBenchmark - LastLevel must be at least 1");
+        return 1;
+    }
+
+    // Use the rules from the game's game mode if we're given one, since its defaults may have been edited
+    APPipesGameMode* gameMode = GetMutableDefault<APPipesGameMode>();
+    if (!gameModePath.IsEmpty())
+    {
+        UClass* gameModeClass = LoadClass<APPipesGameMode>(nullptr, *gameModePath);
+        if (!gameModeClass)
+        {
+            UE_LOG(HoloPipesLog, Error, L"LevelSolverBenchmark - Unable to load game mode %s", *gameModePath);
+            return 1;
+        }
+
+        gameMode = gameModeClass->GetDefaultObject<APPipesGameMode>();
+    }
+
+    // One generator for every level, as the game uses
+    LevelGenerator generator;
+
+    int32 generated = 0;
+    int32 failures = 0;
+    int32 exact = 0;
+    double totalSeconds = 0.0;
+    double worstSeconds = 0.0;
+    int32 worstLevel = 0;
+
+    for (int32 level = 1; level <= lastLevel; level++)
+    {
+        FGenerateOptions options = {};
+        gameMode->BuildOptionsForLevel(level, options);
+        options.StreamPipes = false;
+
+        if (!generator.GenerateLevelSync(options))
+        {
+            UE_LOG(HoloPipesLog, Error, L"LevelSolverBenchmark - Failed to generate level %d", level);
+            failures++;
+            continue;
+        }
+
+        const double seconds = generator.GetLastSolveSeconds();
+
+        generated++;
+        exact += generator.GetParScoreExact() ? 1 : 0;
+        totalSeconds += seconds;
+
+        if (seconds > worstSeconds)
+        {
+            worstSeconds = seconds;
+            worstLevel = level;
+        }
+
+        UE_LOG(HoloPipesLog, Log, L"LevelSolverBenchmark - Level %d: par %d (%s), %d actionable, %f ms",
+            level, generator.GetParScore(), (generator.GetParScoreExact() ? L"exact" : L"heuristic"),
+            static_cast<int32>(generator.VirtualPipes.size()), seconds * 1000.0);
+    }
+
+    UE_LOG(HoloPipesLog, Display, L"LevelSolverBenchmark - %d levels, %d exact, %f ms average, %f ms worst (level %d)",
+        generated, exact, (generated > 0 ? (totalSeconds * 1000.0) / generated : 0.0), worstSeconds * 1000.0, worstLevel);
+
+    return (failures == 0) ? 0 : 1;
+}
@@ -1,1077 +1,1508 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#include "PPipeGrid.h"
-#include "PPipeGrid_Internal.h"
-
-// Sets default values
-APPipeGrid::APPipeGrid() : m_pipesGrid(0, FPipeGridCoordinate::HashOf)
-{
-    PrimaryActorTick.bCanEverTick = true;
-    Toolbox = nullptr;
-    Pawn = nullptr;
-
-	CellSize = 1.0f;
-    TargetCursorEnabled = false;
-    MinGridScale = 0.1;
-    MaxGridScale = 2.5f;
-    m_labelsEnabled = false;
-
-    ChangeRotateAxisTimeout = 0.25f;
-    ShowRotateHandlesTimeout = 0.5f;
-    LoseRotateFocusTimeout = 0.15f;
-
-    FocusGutterRatio = 1.8f;
-
-    m_hands = {};
-}
-
-// Called when the game starts or when spawned
-void APPipeGrid::BeginPlay()
-{
-	Super::BeginPlay();	
-}
-
-void APPipeGrid::Clear()
-{
-    SetInteractionEnabled(false);
-
-	for (auto pipe : m_pipesGrid)
-	{
-        if (pipe.second.pipe)
-        {
-            pipe.second.pipe->Destroy();
-        }
-	}
-
-	m_pipesGrid.clear();
-
-    if (Toolbox)
-    {
-        Toolbox->Clear();
-    }
-
-    ClearCurrentLevelScore();
-}
-
-void APPipeGrid::SetPawn(APMRPawn* pawn)
-{
-    Pawn = pawn;
-    if (pawn)
-    {
-        pawn->OnGestureNotification.AddDynamic(this, &APPipeGrid::HandlePawnGestureUpdate);
-        pawn->OnGazeNotification.AddDynamic(this, &APPipeGrid::HandlePawnGazeUpdate);
-    }
-}
-
-void APPipeGrid::AddPipes(const std::vector<PipeSegmentGenerated>& pipes, AddPipeOptions options)
-{
-	for (const auto& pipeToAdd : pipes)
-	{
-		AddPipe(pipeToAdd, options);
-	}
-}
-
-void APPipeGrid::AddPipe(const PipeSegmentGenerated& pipeToAdd, AddPipeOptions options)
-{
-    if (m_toolboxEnabled && Toolbox)
-    {
-        const bool isToolboxLocation = CoordinateInToolbox(pipeToAdd.Location);
-        const bool isInToolbox = IsAnyFlagSet(options, AddPipeOptions::InToolbox);
-        const bool IsFromToolbox = IsAnyFlagSet(options, AddPipeOptions::FromToolbox);
-
-        if (isToolboxLocation)
-        {
-            if (IsFromToolbox)
-            {
-                // We're being asked to pull a pipe out of the toolbox to spawn into a toolbox location.
-                // We treat that as a no-op
-                return;
-            }
-            else if (!isInToolbox)
-            {
-                // We're being asked to spawn a new pipe that overlaps the toolbox. Just add it to the toolbox instead
-                Toolbox->AddPipe(pipeToAdd.Type);
-                return;
-            }
-            /*
-            else
-            {
-                We're being asked to spawn the pipe that lives in the toolbox, so do so
-            }
-            */
-        }
-
-        else if (IsFromToolbox)
-        {
-            if (Toolbox->CountRemaining(pipeToAdd.Type) > 0)
-            {
-                Toolbox->RemovePipe(pipeToAdd.Type);
-
-                // SpawnInToolbox will just update existing pipes if appopriate, or
-                // create new ones if it hasn't been created yet
-                SpawnInToolbox(pipeToAdd.Type);
-            }
-        }
-    }
-
-    if (PipeClass)
-	{
-		APPipe* newPipe = GetWorld()->SpawnActor<APPipe>(PipeClass);
-
-		if (newPipe)
-		{
-			if (!newPipe->Initialize(pipeToAdd.Type, 
-                                     pipeToAdd.PipeClass, 
-                                     pipeToAdd.Connections, 
-                                     IsAnyFlagSet(options, AddPipeOptions::Fixed), 
-                                     IsAnyFlagSet(options, AddPipeOptions::InToolbox)))
-			{
-				newPipe->Destroy();
-			}
-			else
-			{
-                auto it = m_pipesGrid.find(pipeToAdd.Location);
-                if (it != m_pipesGrid.end() && it->second.pipe)
-                {
-                    it->second.pipe->Destroy();
-                    it->second.pipe = nullptr;
-                }
-
-                GridPipe gridPipe;
-                gridPipe.pipe = newPipe;
-                gridPipe.currentLocation = pipeToAdd.Location;
-                gridPipe.currentPipeClass = pipeToAdd.PipeClass;
-                m_pipesGrid[pipeToAdd.Location] = gridPipe;
-
-                newPipe->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
-                newPipe->SetOwner(this);
-
-                FVector location = GridCoordinateToGridLocation(pipeToAdd.Location);
-                newPipe->SetActorRelativeTransform(FTransform(newPipe->GetDesiredRotation(), location));
-
-                UpdatePipeConnections(pipeToAdd.Location);
-			}
-		}
-	}
-}
-
-void APPipeGrid::FinalizeLevel()
-{
-    // Make sure all the colors/labels are correctly up to date
-    ResolveGridState();
-}
-
-void APPipeGrid::GetCurrentPlaced(std::vector<PipeSegmentGenerated>& realizedPipes)
-{
-    for (auto& pipeEntry : m_pipesGrid)
-    {
-        if (pipeEntry.second.pipe && !pipeEntry.second.pipe->GetPipeFixed() && !pipeEntry.second.pipe->GetInToolbox())
-        {
-            PipeSegmentGenerated segment = {};
-            segment.Type = pipeEntry.second.pipe->GetPipeType();
-            segment.PipeClass = pipeEntry.second.pipe->GetPipeClass();
-            segment.Location = pipeEntry.first;
-            segment.Connections = pipeEntry.second.pipe->GetPipeDirections();
-
-            realizedPipes.push_back(segment);
-        }
-    }
-}
-
-bool APPipeGrid::GetAnyPipesPlaced()
-{
-    for (auto& pipeEntry : m_pipesGrid)
-    {
-        if (pipeEntry.second.pipe && !pipeEntry.second.pipe->GetPipeFixed() && !pipeEntry.second.pipe->GetInToolbox())
-        {
-            return true;
-        }
-    }
-
-    return false;
-}
-
-bool APPipeGrid::GetAnyPlacedPipesDisconnected()
-{
-    for (auto& pipeEntry : m_pipesGrid)
-    {
-        if (pipeEntry.second.pipe && !pipeEntry.second.pipe->GetPipeFixed() && !pipeEntry.second.pipe->GetInToolbox() && pipeEntry.second.pipe->GetPipeClass() == DefaultPipeClass)
-        {
-            return true;
-        }
-    }
-
-    return false;
-}
-
-int32 APPipeGrid::GetActionablePipesCount()
-{
-    int actionablePipes = 0;
-    for (auto& pipeEntry : m_pipesGrid)
-    {
-        if (pipeEntry.second.pipe && !pipeEntry.second.pipe->GetPipeFixed())
-        {
-            actionablePipes++;
-        }
-    }
-
-    return actionablePipes;
-}
-
-GridPipe* APPipeGrid::GetActionablePipe(FPipeGridCoordinate gridLocation)
-{
-    if (!RotateEngaged(gridLocation))
-    {
-        auto it = m_pipesGrid.find(gridLocation);
-
-        if (it != m_pipesGrid.end() &&
-            it->second.pipe &&
-            !it->second.pipe->GetPipeFixed())
-        {
-            return &(it->second);
-        }
-    }
-    
-    return nullptr;
-}
-
-void APPipeGrid::UpdatePipeConnections(const FPipeGridCoordinate& coordinate)
-{
-    auto itTarget = m_pipesGrid.find(coordinate);
-    bool haveTarget = ((itTarget != m_pipesGrid.end()) && itTarget->second.pipe && !itTarget->second.pipe->GetInToolbox());
-
-    PipeDirections targetDirections = haveTarget ? itTarget->second.pipe->GetPipeDirections() : PipeDirections::None;
-    PipeDirections targetConnections = PipeDirections::None;
-
-    for (int i = 0; i < APPipe::ValidDirectionsCount; i++)
-    {
-        PipeDirections targetCandidate = APPipe::ValidDirections[i];
-        PipeDirections neighborCandidate = APPipe::InvertPipeDirection(targetCandidate);
-
-        bool targetCanConnect = IsAnyFlagSet(targetDirections, targetCandidate);
-        bool connected = false;
-
-        auto itNeighbor = m_pipesGrid.find(coordinate + APPipe::PipeDirectionToLocationAdjustment(targetCandidate));
-        bool haveNeighbor = ((itNeighbor != m_pipesGrid.end()) && itNeighbor->second.pipe && !itNeighbor->second.pipe->GetInToolbox());
-
-        if (haveNeighbor)
-        {
-            PipeDirections neighborDirections = itNeighbor->second.pipe->GetPipeDirections();
-            connected = targetCanConnect && IsAnyFlagSet(neighborDirections, neighborCandidate);
-
-            PipeDirections neighborConnections = itNeighbor->second.pipe->GetPipeConnections();
-            itNeighbor->second.pipe->SetPipeConnections(connected ? (neighborConnections | neighborCandidate) : (neighborConnections & ~neighborCandidate));
-        }
-
-        if (connected)
-        {
-            targetConnections |= targetCandidate;
-        }
-    }
-
-    if (haveTarget)
-    {
-        itTarget->second.pipe->SetPipeConnections(targetConnections);
-    }
-}
-
-void APPipeGrid::GetPipeInfo(FPipeGridCoordinate gridLocation, EPipeType* pipeType, int* pipeClass, PipeDirections* connections)
-{
-    auto it = m_pipesGrid.find(gridLocation);
-    if (it != m_pipesGrid.end() && it->second.pipe)
-    {
-        (*pipeType) = it->second.pipe->GetPipeType();
-        (*pipeClass) = it->second.pipe->GetPipeClass();
-        (*connections) = it->second.pipe->GetPipeDirections();
-    }
-    else
-    {
-        (*pipeType) = EPipeType::None;
-        (*pipeClass) = DefaultPipeClass;
-        (*connections) = PipeDirections::None;
-    }
-}
-
-void APPipeGrid::SetInteractionEnabled(bool enabled)
-{
-    if (enabled != m_hands.InteractionEnabled)
-    {
-        ChangeInteractionEnabledForHand(m_hands.Left);
-        ChangeInteractionEnabledForHand(m_hands.Right);
-
-        SendCursorUpdate(FCursorState::Empty, true);
-
-        m_hands.InteractionEnabled = enabled;
-
-        if (Toolbox)
-        {
-            Toolbox->SetFocus(EToolboxFocus::None);
-        }
-    }
-}
-
-void APPipeGrid::ChangeInteractionEnabledForHand(GridHand& hand)
-{
-    HandleDragLost(hand.State);
-    HandleToolboxDragLost(hand.State);
-
-    ClearHand(hand);
-}
-
-void APPipeGrid::ClearHand(GridHand& hand)
-{
-    hand.State.Proxy.Clear();
-    hand.State = {};
-    ClearHandDebounce(hand.State);
-
-#if !UE_BUILD_SHIPPING
-    ClearHandFocusHistory(hand.Focus);
-#endif
-}
-
-void APPipeGrid::ClearHandFocusHistory(GridHandFocus& handFocus)
-{
-    for (auto& pipe : handFocus.HandOnly)
-    {
-        pipe->SetFocusStage(EFocusStage::None);
-    }
-    handFocus.HandOnly.clear();
-
-    for (auto& pipe : handFocus.HandAndGaze)
-    {
-        pipe->SetFocusStage(EFocusStage::None);
-    }
-    handFocus.HandAndGaze.clear();
-}
-
-void APPipeGrid::ClearHandDebounce(GridHandState& handState)
-{
-    handState.Debounce.ShouldKeepFocus.Reset();
-    handState.Debounce.CurrentRotateAxis.Reset();
-    handState.Debounce.ShowRotateHandles.Reset(ShowRotateHandlesTimeout);
-}
-
-
-void APPipeGrid::HandlePawnGazeUpdate(FGazeUpdate update)
-{
-    UpdateGaze(update);
-}
-
-void APPipeGrid::HandlePawnGestureUpdate(FGestureUpdate update)
-{
-    if (m_placeWorldState.Mode != PlaceWorldMode::None)
-    {
-        HandlePlaceWorldGestureUpdate(update);
-    }
-
-#if !UE_BUILD_SHIPPING
-    ClearHandFocusHistory(m_hands.Left.Focus);
-    ClearHandFocusHistory(m_hands.Right.Focus);
-#endif
-
-    HandlePawnGestureUpdateForHand(EFingerHand::Left, update.Left, m_hands.Left);
-    HandlePawnGestureUpdateForHand(EFingerHand::Right, update.Right, m_hands.Right);
-
-    if (Toolbox)
-    {
-        if (IsToolboxDragging())
-        {
-            Toolbox->SetFocus(EToolboxFocus::Carried);
-        }
-        else if (IsToolboxFocused())
-        {
-            Toolbox->SetFocus(EToolboxFocus::Focused);
-        }
-        else
-        {
-            Toolbox->SetFocus(EToolboxFocus::None);
-        }
-    }
-
-    UpdateCursor();
-}
-
-void APPipeGrid::HandlePawnGestureUpdateForHand(EFingerHand fingerHand, const FFingerGestureUpdate& update, GridHand& hand)
-{
-    hand.State.Target.Location = WorldLocationToGridLocation(GetEffectiveTarget(update, hand.State));
-    hand.State.Target.Coordinate = GridLocationToGridCoordinate(hand.State.Target.Location);
-
-    if (m_placeWorldState.Mode == PlaceWorldMode::None)
-    {
-        InteractionMode previousInteractionMode = hand.State.InteractionMode;
-        const APPipe* previousPipe = hand.State.Pipe.Actor;
-
-        if (m_hands.InteractionEnabled)
-        {
-            switch (previousInteractionMode)
-            {
-                case InteractionMode::None:
-                    HandleNoneGestureUpdate(update, hand);
-                    break;
-
-                case InteractionMode::Focus:
-                case InteractionMode::ToolboxFocus:
-                    HandleFocusedGestureUpdate(update, hand);
-                    break;
-
-                case InteractionMode::Translate:
-                    HandleTranslateGestureUpdate(update, hand.State);
-                    break;
-
-                case InteractionMode::Rotate:
-                    HandleRotateGestureUpdate(update, hand.State);
-                    break;
-
-                case InteractionMode::ToolboxTranslate:
-                    HandleToolboxGestureUpdate(update, hand.State);
-                    break;
-            }
-        }
-
-        if (m_hands.InteractionEnabled &&
-            previousInteractionMode != hand.State.InteractionMode)
-        {
-            if (previousInteractionMode == InteractionMode::Rotate || previousInteractionMode == InteractionMode::Translate)
-            {
-                // We have finished an interaction. Update score appropriately
-                ScoreHandRelease(fingerHand, previousPipe);
-                
-                // Also resolve the grid (updating colors as necessary, and checking for a solution).
-                if (!CheckForSolution())
-                {
-                    // We're not in a solution state, but announce that the grid has changed.
-                    OnGridUpdated.Broadcast();
-                }
-            }
-            else if (hand.State.InteractionMode == InteractionMode::Rotate || hand.State.InteractionMode == InteractionMode::Translate)
-            {
-                // We have started an interaction. Update score appropriately
-                ScoreHandGrasp(fingerHand, hand.State.Pipe.Actor);
-            }
-        }
-    }
-
-    switch (update.Progress)
-    {
-        case EGestureProgress::None:
-            hand.State.Target.Phase = EInteractionPhase::None;
-            DetachTarget(hand.State);
-            break;
-
-        case EGestureProgress::Tracked:
-            hand.State.Target.Phase = EInteractionPhase::Pending;
-            DetachTarget(hand.State);
-            break;
-
-        case EGestureProgress::Started:
-        case EGestureProgress::Updated:
-            hand.State.Target.Phase = EInteractionPhase::Ready;
-            AttachTarget(update, hand.State);
-            break;
-
-        case EGestureProgress::Lost:
-            hand.State.Target.Phase = EInteractionPhase::Pending;
-            DetachTarget(hand.State);
-            break;
-    }
-}
-
-void APPipeGrid::UpdateFocus(GridHand& hand)
-{
-    float now = GetWorld()->GetTimeSeconds();
-
-    const FPipeGridCoordinate previousCoord = hand.State.Pipe.StartCoordinate;
-    APPipe* previousPipe = hand.State.Pipe.Actor;
-
-    if (previousPipe != nullptr)
-    {
-        GridPipe* previousGridPipe = GetActionablePipe(previousCoord);
-        if (!previousGridPipe || previousGridPipe->pipe != previousPipe)
-        {
-            // We did have a pipe, but it no longer exists at that location
-            previousPipe = nullptr;
-        }
-    }
-
-    FPipeGridCoordinate toolboxHandleCoord = FPipeGridCoordinate::Zero;
-    const bool haveToolboxHandle = ToolboxCoordinateForType(EPipeType::Start, &toolboxHandleCoord);
-    const bool toolboxHandleFocused = haveToolboxHandle && hand.State.Target.Coordinate == toolboxHandleCoord;
-
-    FPipeGridCoordinate currentCoord = FPipeGridCoordinate::Zero;
-    APPipe* currentPipe = nullptr;
-
-    float currentDistSq = 0;
-
-    const FVector aabbCornerOffset = FVector(CellSize * FocusGutterRatio) / 2.0f;
-
-    // Consider all pipes near the hand to pick the best "point in time" candidate for focus
-    for (int xOffset = -1; xOffset <= 1; xOffset++)
-    {
-        for (int yOffset = -1; yOffset <= 1; yOffset++)
-        {
-            for (int zOffset = -1; zOffset <= 1; zOffset++)
-            {
-                FPipeGridCoordinate candidateCoord = hand.State.Target.Coordinate + FPipeGridCoordinate{ xOffset, yOffset, zOffset };
-                const GridPipe* candidateGridPipe = GetActionablePipe(candidateCoord);
-
-                if (candidateGridPipe && candidateGridPipe->pipe)
-                {
-                    // We have a pipe
-
-                    const FVector candidateLocation = GridCoordinateToGridLocation(candidateCoord);
-                    FVector intersection;
-
-                    if (!candidateGridPipe->pipe->GetInToolbox() && !GazeIntersectsAABB(candidateLocation - aabbCornerOffset, candidateLocation + aabbCornerOffset, &intersection))
-                    {
-                        // The pipe isn't in the toolbox and doesn't have gaze nearby. Ignore it for focus.
-                        // (We don't care about gaze in the toolbox because it is common to interact with the toolbox
-                        // without looking directly at it).
-#if !UE_BUILD_SHIPPING
-                        if (m_debugFocus)
-                        {
-                            
-                            // Ignore it as a focus candidate (still record it for debug visualizations)
-                            candidateGridPipe->pipe->SetFocusStage(EFocusStage::HandOnly);
-                            hand.Focus.HandOnly.push_back(candidateGridPipe->pipe);
-                        }
-#endif
-                    }
-                    else
-                    {
-
-#if !UE_BUILD_SHIPPING
-                        if (m_debugFocus)
-                        {
-                            // The pipe does have gaze nearby, so consider it as a candidate
-                            hand.Focus.HandAndGaze.push_back(candidateGridPipe->pipe);
-                        }
-#endif
-
-                        float candidateDistSq = FVector::DistSquared(hand.State.Target.Location, GridCoordinateToGridLocation(candidateCoord));
-                        bool takeCandidate = (currentPipe == nullptr || candidateDistSq < currentDistSq);
-
-                        if (takeCandidate)
-                        {
-                            // This new pipe is currently the best candidate, so take it (replacing any previous
-                            // best candidate)
-
-#if !UE_BUILD_SHIPPING
-                            if (m_debugFocus && currentPipe != nullptr)
-                            {
-                                // Mark it for visualization (as long as we're not downgrading it)
-                                if (currentPipe->GetFocusStage() != EFocusStage::HandAndGazeAndDistance)
-                                {
-                                    currentPipe->SetFocusStage(EFocusStage::HandAndGaze);
-                                }
-                            }
-#endif
-
-                            currentPipe = candidateGridPipe->pipe;
-                            currentCoord = candidateCoord;
-                            currentDistSq = candidateDistSq;
-                        }
-
-#if !UE_BUILD_SHIPPING
-                        else if (m_debugFocus)
-                        {
-                            // This new pipe isn't the best candidate, so we'll only mark it for
-                            // visualization purposes (but don't downgrade it)
-
-                            if (candidateGridPipe->pipe->GetFocusStage() != EFocusStage::HandAndGazeAndDistance)
-                            {
-                                candidateGridPipe->pipe->SetFocusStage(EFocusStage::HandAndGaze);
-                            }
-                        }
-#endif
-                    }
-                }
-            }
-        }
-    }
-
-    if (currentPipe)
-    {
-
-#if !UE_BUILD_SHIPPING
-
-        if (m_debugFocus)
-        {
-            // We haven't marked the candidate pipe yet, so mark it for visualization
-            currentPipe->SetFocusStage(EFocusStage::HandAndGazeAndDistance);
-        }
-#endif
-
-        if (toolboxHandleFocused)
-        {
-            // Clear out the current pipe if the toolbox handle is focused
-            currentPipe = nullptr;
-        }
-    }
-
-    bool pipeChanged = (currentPipe != previousPipe);
-    bool shouldKeepFocus = true;
-    bool usePrevious = false;
-
-    if (pipeChanged)
-    {
-        if (previousPipe)
-        {
-            // The neighborhood is defined as the pipe itself and its direct neighbors
-            const bool targetInPreviousNeighborhood = (hand.State.Target.Coordinate.DistanceToSq(previousCoord) <= 3.0f);
-
-            // We have a previous pipe. We should only consider using it if we're still in its same neighborhood
-            if (targetInPreviousNeighborhood)
-            {
-                // If we're focusing another pipe, or we're focusing the toolbox handle, we need to consider 
-                // whether the previous pipe should hold on to focus a little longer (ie, if it has ever shown rotate handles 
-                // and our focus has only recently changed to something else)
-                if (currentPipe || toolboxHandleFocused)
-                {
-                    // Focus isn't sticky in the toolbox
-                    if (!previousPipe->GetInToolbox())
-                    {
-                        // We want to keep focus if both fingers and gaze are still pretty close to the previous pipe
-                        const FVector previousLocation = GridCoordinateToGridLocation(previousCoord);
-                        const FVector minAABB = previousLocation - aabbCornerOffset;
-                        const FVector maxAABB = previousLocation + aabbCornerOffset;
-
-                        FVector intersection;
-                        if (GazeIntersectsAABB(minAABB, maxAABB, &intersection))
-                        {
-                            usePrevious = true;
-                            for (int i = 0; usePrevious && i < 3; i++)
-                            {
-                                usePrevious = (hand.State.Target.Location[i] > minAABB[i] && hand.State.Target.Location[i] < maxAABB[i]);
-                            }
-                        }
-
-                        // If we're not close enough to automatically keep focus, keep focus if we haven't timed out yet
-                        if (!usePrevious && hand.State.Debounce.ShouldKeepFocus.UpdateCurrent(false, now))
-                        {
-                            usePrevious = true;
-                            shouldKeepFocus = false;
-                        }
-                    }
-                }
-                else
-                {
-                    usePrevious = true;
-                }
-            }
-        }
-    }
-
-    if (usePrevious)
-    {
-        currentPipe = previousPipe;
-        currentCoord = previousCoord;
-        pipeChanged = false;
-    }
-
-    bool wasShowingRotateHandles = ShowingRotateHandles(hand.State);
-    EInteractionAxis previousRotateHandle = wasShowingRotateHandles ? hand.State.Rotate.CurrentAxis : EInteractionAxis::None;
-
-    if (currentPipe)
-    {
-        // We've got a current pipe, so update our state
-        hand.State.InteractionMode = InteractionMode::Focus;
-        hand.State.Pipe.Actor = currentPipe;
-        hand.State.Pipe.StartCoordinate = currentCoord;
-        hand.State.Pipe.StartDirections = hand.State.Pipe.Actor->GetPipeDirections();
-        hand.State.Pipe.StartRotation = hand.State.Pipe.Actor->GetDesiredRotation().Quaternion();
-
-        EInteractionAxis nextHandleAxis = EInteractionAxis::None;
-        FVector nextHandleLocation = FVector::ZeroVector;
-
-        if (pipeChanged)
-        {
-            hand.State.Debounce.ShouldKeepFocus.Reset();
-            hand.State.Debounce.ShouldKeepFocus.SetCurrent(true);
-
-            hand.State.Debounce.CurrentRotateAxis.Reset();
-            hand.State.Debounce.CurrentRotateAxis.SetCurrent(EInteractionAxis::None);
-
-            hand.State.Debounce.ShowRotateHandles.SetCurrent(false);
-        }
-        else
-        {
-            if (hand.State.Debounce.ShowRotateHandles.UpdateCurrent(m_rotateEnabled && !currentPipe->GetInToolbox(), now))
-            {
-                ComputeCurrentRotationHandle(currentCoord, hand.State, &nextHandleAxis, &nextHandleLocation);
-
-                if (!wasShowingRotateHandles)
-                {
-                    hand.State.Debounce.ShouldKeepFocus.Reset(LoseRotateFocusTimeout);
-                    hand.State.Debounce.ShouldKeepFocus.SetCurrent(true);
-
-                    hand.State.Debounce.CurrentRotateAxis.Reset(ChangeRotateAxisTimeout);
-                    hand.State.Debounce.CurrentRotateAxis.SetCurrent(nextHandleAxis);
-                }
-            }
-
-            if (shouldKeepFocus)
-            {
-                hand.State.Debounce.ShouldKeepFocus.SetCurrent(true);
-            }
-        }
-
-        if (nextHandleAxis == hand.State.Debounce.CurrentRotateAxis.UpdateCurrent(nextHandleAxis, now))
-        {
-            hand.State.Rotate.CurrentAxis = nextHandleAxis;
-            hand.State.Rotate.HandleLocation = nextHandleLocation;
-        }
-    }
-    else
-    {
-        // We don't have a current pipe, so clear our state
-        hand.State.Pipe = {};
-        
-        ClearHandDebounce(hand.State);
-        hand.State.Rotate.CurrentAxis = EInteractionAxis::None;
-        hand.State.Rotate.HandleLocation = FVector::ZeroVector;
-
-        // And check if we're focusing the toolbox
-
-        if (toolboxHandleFocused && !IsToolboxDragging())
-        {
-            hand.State.InteractionMode = InteractionMode::ToolboxFocus;
-            hand.State.Pipe.StartCoordinate = toolboxHandleCoord;
-        }
-        else
-        {
-            hand.State.InteractionMode = InteractionMode::None;
-        }
-    }
-
-    bool isShowingRotateHandles = ShowingRotateHandles(hand.State);
-    EInteractionAxis currentRotateHandle = isShowingRotateHandles ? hand.State.Rotate.CurrentAxis : EInteractionAxis::None;
-
-    if (currentRotateHandle != previousRotateHandle)
-    {
-        OnRotateHandleShown.Broadcast(currentRotateHandle == EInteractionAxis::None ? currentCoord : previousCoord, currentRotateHandle);
-    }
-}
-
-void APPipeGrid::HandleNoneGestureUpdate(const FFingerGestureUpdate& update, GridHand& hand)
-{
-    GridHandTarget oldTarget = hand.State.Target;
-    ClearHand(hand);
-
-    hand.State.Target = oldTarget;
-    hand.State.InteractionMode = InteractionMode::None;
-
-    switch (update.Progress)
-    {
-        case EGestureProgress::Tracked:
-        case EGestureProgress::Started:
-        case EGestureProgress::Updated:
-            UpdateFocus(hand);
-            break;
-    }
-}
-
-void APPipeGrid::HandleFocusedGestureUpdate(const FFingerGestureUpdate& update, GridHand& hand)
-{
-    switch (update.Progress)
-    {
-        case EGestureProgress::None:
-        case EGestureProgress::Lost:
-            hand.State.InteractionMode = InteractionMode::None;
-            break;
-
-        case EGestureProgress::Tracked:
-            UpdateFocus(hand);
-            break;
-
-        case EGestureProgress::Started:
-        {
-            bool handled = false;
-            if (hand.State.InteractionMode == InteractionMode::ToolboxFocus)
-            {
-                handled = TryHandleStartToolboxDrag(hand.State);
-            }
-
-            if (!handled)
-            {
-                handled = TryHandleDragStart(update, hand.State);
-            }
-
-            if (!handled)
-            {
-                handled = TryHandleRotateStart(hand.State);
-                if (handled)
-                {
-                    hand.State.Debounce.ShowRotateHandles.SetCurrent(true);
-                }
-            }
-
-
-            break;
-        }
-
-        case EGestureProgress::Updated:
-
-            UpdateFocus(hand);
-            TryHandleDragStart(update, hand.State);
-
-            // We don't allow rotation if we enter a pipe's focus area already pinched
-            hand.State.Debounce.ShowRotateHandles.SetCurrent(false);
-
-            break;
-    }
-}
-
-
-bool APPipeGrid::PipeConnected(const GridPipe& pipe, PipeDirections direction)
-{
-    bool connected = false;
-
-    PipeDirections connections = pipe.pipe->GetPipeDirections();
-    if (IsAnyFlagSet(direction, connections))
-    {
-        // This direction represents an outbound connection, see if there's a neighbor
-        FPipeGridCoordinate neighborLocation = pipe.currentLocation + APPipe::PipeDirectionToLocationAdjustment(direction);
-        auto itFind = m_pipesGrid.find(neighborLocation);
-
-        if (itFind != m_pipesGrid.end())
-        {
-            if (itFind->second.pipe && !itFind->second.pipe->GetInToolbox())
-            {
-                // There's a pipe at that location (and it's not in the toolbox), see if it connects back to us
-                if (IsAnyFlagSet(itFind->second.pipe->GetPipeDirections(), APPipe::InvertPipeDirection(direction)))
-                {
-                    // It does! We are connected
-                    connected = true;
-                }
-            }
-        }
-    }
-
-    return connected;
-}
-
-bool APPipeGrid::PipeConnected(const FPipeGridCoordinate& pipeCoordinate)
-{
-    bool connected = false;
-    auto itTarget = m_pipesGrid.find(pipeCoordinate);
-
-    if (itTarget != m_pipesGrid.end())
-    {
-        GridPipe& gridPipe = itTarget->second;
-
-        if (gridPipe.pipe && !gridPipe.pipe->GetInToolbox())
-        {
-            connected = (gridPipe.pipe->GetPipeClass() != DefaultPipeClass);
-
-            if (!connected)
-            {
-                // Pipes can be connected and still be the default pipe class if no 
-                // connected pipe is ultiamtely connected to a start or end      
-
-                for (int i = 0; !connected && i < APPipe::ValidDirectionsCount; i++)
-                {
-                    PipeDirections currentConnection = APPipe::ValidDirections[i];
-                    connected = PipeConnected(gridPipe, currentConnection);
-                }
-            }
-        }
-    }
-
-    return connected;
-}
-
-bool APPipeGrid::CheckForSolution()
-{
-    bool solution = ResolveGridState();
-
-    if (solution)
-    {
-        // The grid is in a solution state (ie, no disconnected pipes, no open pipe connections, 
-        // all connected pipes are in the same class, and no pipes left in the toolbox).
-        // Announce the solution.
-        OnGridSolved.Broadcast();
-    }
-    
-    return solution;
-}
-
-bool APPipeGrid::ResolveGridState()
-{
-    int openConnections = 0;
-    int disconnectedPipes = 0;
-
-    // Any pipe we're currently dragging is disconnected by definition
-    if (m_hands.Left.State.InteractionMode == InteractionMode::Translate && m_hands.Left.State.Pipe.Actor != nullptr)
-    {
-        disconnectedPipes++;
-    }
-    if (m_hands.Right.State.InteractionMode == InteractionMode::Translate && m_hands.Right.State.Pipe.Actor != nullptr)
-    {
-        disconnectedPipes++;
-    }
-    
-    // Step 1: Setup
-    // We go through all GridPipes, adding fixed ones to
-    // the open list (with their current PipeClass), and marking all
-    // others as the default pipe class
-    auto itSetup = m_pipesGrid.begin();
-    while (itSetup != m_pipesGrid.end())
-    {
-        if (itSetup->second.pipe && !itSetup->second.pipe->GetInToolbox() && itSetup->second.pipe->GetPipeType() != EPipeType::Block)
-        {
-            if (itSetup->second.pipe->GetPipeFixed())
-            {
-                m_openList.push_back(&(itSetup->second));
-            }
-            else
-            {
-                itSetup->second.currentPipeClass = DefaultPipeClass;
-            }
-        }
-
-        itSetup++;
-    }
-
-    // Step 2: Walk
-    // As long as the open list isn't empty, pick off the first item. 
-    // Iterate that item's outbound connections and:
-    //   * If that connection has a connected neighbor:
-    //     * If the neighbor is still in the Default class, add it to this piece's class and stick in in the open list
-    //     * If the neighbor is already in the same class, ignore it
-    //     * If the neighbor is in a different class, treat it as an open connection and increment the open connections count
-    //   * If that connection has no connected neighbor, increment the open connections count
-    while (!m_openList.empty())
-    {
-        GridPipe* gridPipe = m_openList.front();
-        m_openList.pop_front();
-
-        PipeDirections connections = gridPipe->pipe->GetPipeDirections();
-        bool shouldShowLabel = false;
-
-        for (int i = 0; i < APPipe::ValidDirectionsCount; i++)
-        {
-            PipeDirections currentConnection = APPipe::ValidDirections[i];
-            if (IsAnyFlagSet(connections, currentConnection))
-            {
-                // This direction represents an outbound connection, see if there's a neighbor
-                FPipeGridCoordinate neighborLocation = gridPipe->currentLocation + APPipe::PipeDirectionToLocationAdjustment(currentConnection);
-
-                auto itFind = m_pipesGrid.find(neighborLocation);
-
-                if (itFind == m_pipesGrid.end() || !itFind->second.pipe)
-                {
-                    // There's no pipe at that location, so it's an open connection
-                    openConnections++;
-                    shouldShowLabel = true;
-                }
-
-                else if (!itFind->second.pipe || itFind->second.pipe->GetInToolbox())
-                {
-                    // The neighbor is null or is in the toolbox, so it's disconnected by definition
-                    openConnections++;
-                    shouldShowLabel = true;
-                }
-
-                // Ignore pipes that are already in our class
-                else if (itFind->second.currentPipeClass == gridPipe->currentPipeClass)
-                {
-                    // The neighbor is in our class. Make sure it has a connection back to us
-                    if (!IsAnyFlagSet(itFind->second.pipe->GetPipeDirections(), APPipe::InvertPipeDirection(currentConnection)))
-                    {
-                        // It doesn't, so this is an open connection
-                        openConnections++;
-                        shouldShowLabel = true;
-                    }
-                }
-                else
-                {
-                    // The neighbor isn't in our class
-                    if (itFind->second.currentPipeClass != DefaultPipeClass)
-                    {
-                        // The neighbor is already in a class, so it counts as an open connection
-                        openConnections++;
-                        shouldShowLabel = true;
-                    }
-                    else
-                    {
-                        // The neighbor pipe can be added to our class. Make sure it has a connection back to us
-                        if (!IsAnyFlagSet(itFind->second.pipe->GetPipeDirections(), APPipe::InvertPipeDirection(currentConnection)))
-                        {
-                            // It doesn't, so this is an open connection
-                            openConnections++;
-                            shouldShowLabel = true;
-                        }
-                        else
-                        {
-                            // It does! Add it to our class and add it to the open list
-                            itFind->second.currentPipeClass = gridPipe->currentPipeClass;
-                            m_openList.push_back(&itFind->second);
-                        }
-                    }
-                }
-            }
-        }
-
-        gridPipe->pipe->SetShowLabel(shouldShowLabel && m_labelsEnabled);
-    }
-
-    // Step 3: Cleanup
-    // Count how many pipes are disconnected from starts/ends, and update 
-    // the class of all pipes that have changed during resolution
-    auto itCleanup = m_pipesGrid.begin();
-    while (itCleanup != m_pipesGrid.end())
-    {
-        if (itCleanup->second.pipe)
-        {
-            if (itCleanup->second.currentPipeClass == DefaultPipeClass)
-            {
-                itCleanup->second.pipe->SetShowLabel(false);
-
-                if (!itCleanup->second.pipe->GetInToolbox() && itCleanup->second.pipe->GetPipeType() != EPipeType::Block)
-                {
-                    disconnectedPipes++;
-                }
-            }
-
-            if (itCleanup->second.currentPipeClass != itCleanup->second.pipe->GetPipeClass())
-            {
-                itCleanup->second.pipe->SetPipeClass(itCleanup->second.currentPipeClass);
-            }
-        }
-
-        itCleanup++;
-    }
-
-    bool solution = (openConnections == 0 && disconnectedPipes == 0);
-
-    // Step 4:
-    // Reutrn whether we're in a solution state; that means all pipe connections are connected,
-    // all placed pipes are in a non-default class, and all pipe pieces are in the same class as their 
-    // connected neighbors
-    return solution;
-}
-
-void APPipeGrid::SetLabelsEnabled(bool enabled)
-{
-    if (m_labelsEnabled != enabled)
-    {
-        m_labelsEnabled = enabled;
-        ResolveGridState();
-    }
-}
-
-bool APPipeGrid::GetLabelsEnabled()
-{
-    return m_labelsEnabled;
-}
-
-
-bool APPipeGrid::ToggleDebugFocus()
-{
-#if UE_BUILD_SHIPPING
-    return false;
-#else
-    m_debugFocus = !m_debugFocus;
-    return true;
-#endif
-}
\ No newline at end of file
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#include "PPipeGrid.h"
+#include "PPipeGrid_Internal.h"
+#include <algorithm>
+
+// Sets default values
+APPipeGrid::APPipeGrid()
+{
+    PrimaryActorTick.bCanEverTick = true;
+
+    // Late in the frame, so pipe events queued by this frame's input go out this frame
+    PrimaryActorTick.TickGroup = TG_PostUpdateWork;
+
+    Toolbox = nullptr;
+    Pawn = nullptr;
+
+	CellSize = 1.0f;
+    TargetCursorEnabled = false;
+    MinGridScale = 0.1;
+    MaxGridScale = 2.5f;
+    PopulateBudgetMs = 4.0f;
+    AsyncResolveMinPipes = 4096;
+    m_labelsEnabled = false;
+
+    ChangeRotateAxisTimeout = 0.25f;
+    ShowRotateHandlesTimeout = 0.5f;
+    LoseRotateFocusTimeout = 0.15f;
+
+    FocusGutterRatio = 1.8f;
+
+    UndoScoring = EUndoScoring::Refund;
+    UndoScorePenalty = 1;
+
+    m_hands = {};
+}
+
+void APPipeGrid::PostInitializeComponents()
+{
+    Super::PostInitializeComponents();
+
+    // Wherever the grid was spawned, it's been moved since anything was cached
+    MarkGridTransformDirty();
+
+    // Every move of the grid goes through its root, whether it's made here, from a blueprint, or by
+    // whatever the grid is attached to. Bound here rather than in BeginPlay, since tools that spawn
+    // the grid into a bare world never start play
+    if (RootComponent)
+    {
+        RootComponent->TransformUpdated.AddUObject(this, &APPipeGrid::HandleRootTransformUpdated);
+    }
+}
+
+// Called when the game starts or when spawned
+void APPipeGrid::BeginPlay()
+{
+	Super::BeginPlay();	
+}
+
+void APPipeGrid::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    UpdatePopulation();
+    UpdateAsyncResolve(false /* wait */);
+    FlushPipeEvents();
+}
+
+void APPipeGrid::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    DestroyPipePool();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void APPipeGrid::QueuePipeEvents(APPipe* pipe)
+{
+    m_pipeEventQueue.push_back(pipe);
+}
+
+void APPipeGrid::FlushPipeEvents()
+{
+    HOLOPIPES_PROFILE_SCOPE(GridPipeEvents);
+
+    // Anything queued by the events themselves goes out next frame
+    std::swap(m_pipeEventQueue, m_pipeEventsFlushing);
+
+    for (const TWeakObjectPtr<APPipe>& pipe : m_pipeEventsFlushing)
+    {
+        if (pipe.IsValid())
+        {
+            pipe->FlushPipeEvents();
+        }
+    }
+
+    m_pipeEventsFlushing.clear();
+}
+
+void APPipeGrid::Clear()
+{
+#if !UE_BUILD_SHIPPING
+    EndInputRecording();
+#endif
+
+    SetInteractionEnabled(false);
+
+    // Released a few at a time by UpdatePopulation, so clearing a big level doesn't stall a frame
+	for (auto pipe : m_pipesGrid)
+	{
+        if (pipe.second.pipe)
+        {
+            m_retiringPipes.push_back(pipe.second.pipe);
+        }
+	}
+
+	m_pipesGrid.clear();
+    m_populationBatches.clear();
+
+    for (auto& pipeSet : m_pipeSets)
+    {
+        pipeSet.clear();
+    }
+
+    CancelAsyncResolve();
+    m_connectivityGeneration++;
+
+    m_dirtyConnectivity.clear();
+    m_openConnections = 0;
+    m_disconnectedPipes = 0;
+
+    if (Toolbox)
+    {
+        Toolbox->Clear();
+    }
+
+    ClearCurrentLevelScore();
+    ClearJournal();
+}
+
+void APPipeGrid::SetPawn(APMRPawn* pawn)
+{
+    Pawn = pawn;
+    if (pawn)
+    {
+        pawn->OnGestureNotification.AddDynamic(this, &APPipeGrid::HandlePawnGestureUpdate);
+        pawn->OnGazeNotification.AddDynamic(this, &APPipeGrid::HandlePawnGazeUpdate);
+    }
+}
+
+void APPipeGrid::AddPipes(const std::vector<PipeSegmentGenerated>& pipes, AddPipeOptions options)
+{
+	for (const auto& pipeToAdd : pipes)
+	{
+		AddPipe(pipeToAdd, options);
+	}
+}
+
+void APPipeGrid::AddPipe(const PipeSegmentGenerated& pipeToAdd, AddPipeOptions options)
+{
+    if (m_toolboxEnabled && Toolbox)
+    {
+        const bool isToolboxLocation = CoordinateInToolbox(pipeToAdd.Location);
+        const bool isInToolbox = IsAnyFlagSet(options, AddPipeOptions::InToolbox);
+        const bool IsFromToolbox = IsAnyFlagSet(options, AddPipeOptions::FromToolbox);
+
+        if (isToolboxLocation)
+        {
+            if (IsFromToolbox)
+            {
+                // We're being asked to pull a pipe out of the toolbox to spawn into a toolbox location.
+                // We treat that as a no-op
+                return;
+            }
+            else if (!isInToolbox)
+            {
+                // We're being asked to spawn a new pipe that overlaps the toolbox. Just add it to the toolbox instead
+                Toolbox->AddPipe(pipeToAdd.Type);
+                return;
+            }
+            /*
+            else
+            {
+                We're being asked to spawn the pipe that lives in the toolbox, so do so
+            }
+            */
+        }
+
+        else if (IsFromToolbox)
+        {
+            if (Toolbox->CountRemaining(pipeToAdd.Type) > 0)
+            {
+                Toolbox->RemovePipe(pipeToAdd.Type);
+
+                // SpawnInToolbox will just update existing pipes if appopriate, or
+                // create new ones if it hasn't been created yet
+                SpawnInToolbox(pipeToAdd.Type);
+            }
+        }
+    }
+
+    if (PipeClass)
+	{
+		APPipe* newPipe = AcquirePipe(pipeToAdd.Type);
+
+		if (newPipe)
+		{
+			if (!newPipe->Initialize(pipeToAdd.Type, 
+                                     pipeToAdd.PipeClass, 
+                                     pipeToAdd.Connections, 
+                                     IsAnyFlagSet(options, AddPipeOptions::Fixed), 
+                                     IsAnyFlagSet(options, AddPipeOptions::InToolbox)))
+			{
+				ReleasePipe(newPipe);
+			}
+			else
+			{
+                MarkConnectivityDirty(pipeToAdd.Location);
+
+                auto it = m_pipesGrid.find(pipeToAdd.Location);
+                if (it != m_pipesGrid.end() && it->second.pipe)
+                {
+                    ReleasePipe(it->second.pipe);
+                    it->second.pipe = nullptr;
+                }
+
+                GridPipe gridPipe;
+                gridPipe.pipe = newPipe;
+                gridPipe.currentLocation = pipeToAdd.Location;
+                gridPipe.currentPipeClass = pipeToAdd.PipeClass;
+                PutGridPipe(gridPipe);
+
+                newPipe->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
+                newPipe->SetOwner(this);
+
+                FVector location = GridCoordinateToGridLocation(pipeToAdd.Location);
+                newPipe->SetActorRelativeTransform(FTransform(newPipe->GetDesiredRotation(), location));
+
+                UpdatePipeConnections(pipeToAdd.Location);
+			}
+		}
+	}
+}
+
+void APPipeGrid::FinalizeLevel()
+{
+    // Make sure all the colors/labels are correctly up to date. Big levels get there a few frames later
+    ResolveGridStateAsync();
+}
+
+void APPipeGrid::GetCurrentPlaced(std::vector<PipeSegmentGenerated>& realizedPipes)
+{
+    const std::vector<FPipeGridCoordinate>& placed = m_pipeSets[static_cast<int>(GridPipeSet::Placed)];
+    realizedPipes.reserve(realizedPipes.size() + placed.size());
+
+    for (const FPipeGridCoordinate& coordinate : placed)
+    {
+        const APPipe* pipe = m_pipesGrid.find(coordinate)->second.pipe;
+
+        PipeSegmentGenerated segment = {};
+        segment.Type = pipe->GetPipeType();
+        segment.PipeClass = pipe->GetPipeClass();
+        segment.Location = coordinate;
+        segment.Connections = pipe->GetPipeDirections();
+
+        realizedPipes.push_back(segment);
+    }
+}
+
+bool APPipeGrid::GetAnyPipesPlaced()
+{
+    return !m_pipeSets[static_cast<int>(GridPipeSet::Placed)].empty();
+}
+
+bool APPipeGrid::GetAnyPlacedPipesDisconnected()
+{
+    return !m_pipeSets[static_cast<int>(GridPipeSet::PlacedDisconnected)].empty();
+}
+
+int32 APPipeGrid::GetActionablePipesCount()
+{
+    return static_cast<int32>(m_pipeSets[static_cast<int>(GridPipeSet::Placed)].size() +
+                              m_pipeSets[static_cast<int>(GridPipeSet::Toolbox)].size());
+}
+
+void APPipeGrid::IndexPipe(GridPipe& gridPipe)
+{
+    APPipe* pipe = gridPipe.pipe;
+    const bool fixed = pipe && pipe->GetPipeFixed();
+    const bool inToolbox = pipe && !fixed && pipe->GetInToolbox();
+    const bool placed = pipe && !fixed && !inToolbox;
+
+    bool member[static_cast<int>(GridPipeSet::Count)] = {};
+    member[static_cast<int>(GridPipeSet::Placed)] = placed;
+    member[static_cast<int>(GridPipeSet::Toolbox)] = inToolbox;
+    member[static_cast<int>(GridPipeSet::Fixed)] = fixed;
+    member[static_cast<int>(GridPipeSet::PlacedDisconnected)] = placed && pipe->GetPipeClass() == DefaultPipeClass;
+
+    for (int set = 0; set < static_cast<int>(GridPipeSet::Count); set++)
+    {
+        std::vector<FPipeGridCoordinate>& pipeSet = m_pipeSets[set];
+        int32& index = gridPipe.setIndex[set];
+
+        if (member[set] && index < 0)
+        {
+            index = static_cast<int32>(pipeSet.size());
+            pipeSet.push_back(gridPipe.currentLocation);
+        }
+        else if (!member[set] && index >= 0)
+        {
+            // Move the last pipe in the set into the hole, and tell it where it went
+            if (index != static_cast<int32>(pipeSet.size()) - 1)
+            {
+                pipeSet[index] = pipeSet.back();
+                m_pipesGrid.find(pipeSet[index])->second.setIndex[set] = index;
+            }
+
+            pipeSet.pop_back();
+            index = -1;
+        }
+    }
+}
+
+void APPipeGrid::UnindexPipe(GridPipe& gridPipe)
+{
+    APPipe* pipe = gridPipe.pipe;
+    gridPipe.pipe = nullptr;
+    IndexPipe(gridPipe);
+    gridPipe.pipe = pipe;
+}
+
+GridPipe& APPipeGrid::PutGridPipe(const GridPipe& gridPipe)
+{
+    GridPipe& entry = m_pipesGrid[gridPipe.currentLocation];
+    UnindexPipe(entry);
+    m_connectivityGeneration++;
+
+    entry = gridPipe;
+    for (int32& index : entry.setIndex)
+    {
+        index = -1;
+    }
+
+    IndexPipe(entry);
+    return entry;
+}
+
+PipeGridStorage<GridPipe>::iterator APPipeGrid::EraseGridPipe(PipeGridStorage<GridPipe>::iterator it)
+{
+    UnindexPipe(it->second);
+    m_connectivityGeneration++;
+    return m_pipesGrid.erase(it);
+}
+
+GridPipe* APPipeGrid::GetActionablePipe(FPipeGridCoordinate gridLocation)
+{
+    if (!RotateEngaged(gridLocation))
+    {
+        auto it = m_pipesGrid.find(gridLocation);
+
+        if (it != m_pipesGrid.end() &&
+            it->second.pipe &&
+            !it->second.pipe->GetPipeFixed())
+        {
+            return &(it->second);
+        }
+    }
+    
+    return nullptr;
+}
+
+void APPipeGrid::UpdatePipeConnections(const FPipeGridCoordinate& coordinate)
+{
+    auto itTarget = m_pipesGrid.find(coordinate);
+    bool haveTarget = ((itTarget != m_pipesGrid.end()) && itTarget->second.pipe && !itTarget->second.pipe->GetInToolbox());
+
+    PipeDirections targetDirections = haveTarget ? itTarget->second.pipe->GetPipeDirections() : PipeDirections::None;
+    PipeDirections targetConnections = PipeDirections::None;
+
+    for (int i = 0; i < APPipe::ValidDirectionsCount; i++)
+    {
+        PipeDirections targetCandidate = APPipe::ValidDirections[i];
+        PipeDirections neighborCandidate = APPipe::InvertPipeDirection(targetCandidate);
+
+        bool targetCanConnect = IsAnyFlagSet(targetDirections, targetCandidate);
+        bool connected = false;
+
+        auto itNeighbor = m_pipesGrid.find(coordinate + APPipe::PipeDirectionToLocationAdjustment(targetCandidate));
+        bool haveNeighbor = ((itNeighbor != m_pipesGrid.end()) && itNeighbor->second.pipe && !itNeighbor->second.pipe->GetInToolbox());
+
+        if (haveNeighbor)
+        {
+            PipeDirections neighborDirections = itNeighbor->second.pipe->GetPipeDirections();
+            connected = targetCanConnect && IsAnyFlagSet(neighborDirections, neighborCandidate);
+
+            PipeDirections neighborConnections = itNeighbor->second.pipe->GetPipeConnections();
+            itNeighbor->second.pipe->SetPipeConnections(connected ? (neighborConnections | neighborCandidate) : (neighborConnections & ~neighborCandidate));
+        }
+
+        if (connected)
+        {
+            targetConnections |= targetCandidate;
+        }
+    }
+
+    if (haveTarget)
+    {
+        itTarget->second.pipe->SetPipeConnections(targetConnections);
+    }
+}
+
+void APPipeGrid::GetPipeInfo(FPipeGridCoordinate gridLocation, EPipeType* pipeType, int* pipeClass, PipeDirections* connections)
+{
+    auto it = m_pipesGrid.find(gridLocation);
+    if (it != m_pipesGrid.end() && it->second.pipe)
+    {
+        (*pipeType) = it->second.pipe->GetPipeType();
+        (*pipeClass) = it->second.pipe->GetPipeClass();
+        (*connections) = it->second.pipe->GetPipeDirections();
+    }
+    else
+    {
+        (*pipeType) = EPipeType::None;
+        (*pipeClass) = DefaultPipeClass;
+        (*connections) = PipeDirections::None;
+    }
+}
+
+void APPipeGrid::SetInteractionEnabled(bool enabled)
+{
+    // Nothing can be picked up until the level is all there
+    if (IsPopulating())
+    {
+        m_enableInteractionWhenPopulated = enabled;
+        if (enabled)
+        {
+            return;
+        }
+    }
+
+    if (enabled != m_hands.InteractionEnabled)
+    {
+        ChangeInteractionEnabledForHand(m_hands.Left);
+        ChangeInteractionEnabledForHand(m_hands.Right);
+
+        SendCursorUpdate(FCursorState::Empty, true);
+
+        m_hands.InteractionEnabled = enabled;
+
+        if (Toolbox)
+        {
+            Toolbox->SetFocus(EToolboxFocus::None);
+        }
+    }
+}
+
+void APPipeGrid::ChangeInteractionEnabledForHand(GridHand& hand)
+{
+    HandleDragLost(hand.State);
+    HandleToolboxDragLost(hand.State);
+
+    ClearHand(hand);
+}
+
+void APPipeGrid::ClearHand(GridHand& hand)
+{
+    ReleaseProxy(hand.State.Proxy);
+    hand.State = {};
+    ClearHandDebounce(hand.State);
+
+#if !UE_BUILD_SHIPPING
+    ClearHandFocusHistory(hand.Focus);
+#endif
+}
+
+void APPipeGrid::ClearHandFocusHistory(GridHandFocus& handFocus)
+{
+    for (auto& pipe : handFocus.HandOnly)
+    {
+        pipe->SetFocusStage(EFocusStage::None);
+    }
+    handFocus.HandOnly.clear();
+
+    for (auto& pipe : handFocus.HandAndGaze)
+    {
+        pipe->SetFocusStage(EFocusStage::None);
+    }
+    handFocus.HandAndGaze.clear();
+}
+
+void APPipeGrid::ClearHandDebounce(GridHandState& handState)
+{
+    handState.Debounce.ShouldKeepFocus.Reset();
+    handState.Debounce.CurrentRotateAxis.Reset();
+    handState.Debounce.ShowRotateHandles.Reset(ShowRotateHandlesTimeout);
+}
+
+
+void APPipeGrid::HandlePawnGazeUpdate(FGazeUpdate update)
+{
+#if !UE_BUILD_SHIPPING
+    RecordGaze(update);
+#endif
+
+    HOLOPIPES_PROFILE_SCOPE(GridGaze);
+    UpdateGaze(update);
+}
+
+void APPipeGrid::HandlePawnGestureUpdate(FGestureUpdate update)
+{
+#if !UE_BUILD_SHIPPING
+    RecordGesture(update);
+#endif
+
+    if (m_placeWorldState.Mode != PlaceWorldMode::None)
+    {
+        HandlePlaceWorldGestureUpdate(update);
+    }
+
+#if !UE_BUILD_SHIPPING
+    ClearHandFocusHistory(m_hands.Left.Focus);
+    ClearHandFocusHistory(m_hands.Right.Focus);
+#endif
+
+    HandlePawnGestureUpdateForHand(EFingerHand::Left, update.Left, m_hands.Left);
+    HandlePawnGestureUpdateForHand(EFingerHand::Right, update.Right, m_hands.Right);
+
+    if (Toolbox)
+    {
+        if (IsToolboxDragging())
+        {
+            Toolbox->SetFocus(EToolboxFocus::Carried);
+        }
+        else if (IsToolboxFocused())
+        {
+            Toolbox->SetFocus(EToolboxFocus::Focused);
+        }
+        else
+        {
+            Toolbox->SetFocus(EToolboxFocus::None);
+        }
+    }
+
+    HOLOPIPES_PROFILE_SCOPE(GridCursor);
+    UpdateCursor();
+}
+
+void APPipeGrid::HandlePawnGestureUpdateForHand(EFingerHand fingerHand, const FFingerGestureUpdate& update, GridHand& hand)
+{
+    hand.State.Target.Location = WorldLocationToGridLocation(GetEffectiveTarget(update, hand.State));
+    hand.State.Target.Coordinate = GridLocationToGridCoordinate(hand.State.Target.Location);
+
+    if (m_placeWorldState.Mode == PlaceWorldMode::None)
+    {
+        InteractionMode previousInteractionMode = hand.State.InteractionMode;
+        const APPipe* previousPipe = hand.State.Pipe.Actor;
+
+        if (m_hands.InteractionEnabled)
+        {
+            switch (previousInteractionMode)
+            {
+                case InteractionMode::None:
+                    HandleNoneGestureUpdate(update, hand);
+                    break;
+
+                case InteractionMode::Focus:
+                case InteractionMode::ToolboxFocus:
+                    HandleFocusedGestureUpdate(update, hand);
+                    break;
+
+                case InteractionMode::Translate:
+                {
+                    HOLOPIPES_PROFILE_SCOPE(GridDrag);
+                    HandleTranslateGestureUpdate(update, hand.State);
+                    break;
+                }
+
+                case InteractionMode::Rotate:
+                {
+                    HOLOPIPES_PROFILE_SCOPE(GridRotate);
+                    HandleRotateGestureUpdate(update, hand.State);
+                    break;
+                }
+
+                case InteractionMode::ToolboxTranslate:
+                {
+                    HOLOPIPES_PROFILE_SCOPE(GridToolbox);
+                    HandleToolboxGestureUpdate(update, hand.State);
+                    break;
+                }
+            }
+        }
+
+        if (m_hands.InteractionEnabled &&
+            previousInteractionMode != hand.State.InteractionMode)
+        {
+            if (previousInteractionMode == InteractionMode::Rotate || previousInteractionMode == InteractionMode::Translate)
+            {
+                // We have finished an interaction. Update score appropriately
+                ScoreHandRelease(fingerHand, previousPipe);
+                
+                // Also resolve the grid (updating colors as necessary, and checking for a solution).
+                if (!CheckForSolution())
+                {
+                    // We're not in a solution state, but announce that the grid has changed.
+                    OnGridUpdated.Broadcast();
+                }
+            }
+            else if (hand.State.InteractionMode == InteractionMode::Rotate || hand.State.InteractionMode == InteractionMode::Translate)
+            {
+                // We have started an interaction. Update score appropriately
+                hand.State.Pipe.GraspScored = ScoreHandGrasp(fingerHand, hand.State.Pipe.Actor);
+            }
+        }
+    }
+
+    switch (update.Progress)
+    {
+        case EGestureProgress::None:
+            hand.State.Target.Phase = EInteractionPhase::None;
+            DetachTarget(hand.State);
+            break;
+
+        case EGestureProgress::Tracked:
+            hand.State.Target.Phase = EInteractionPhase::Pending;
+            DetachTarget(hand.State);
+            break;
+
+        case EGestureProgress::Started:
+        case EGestureProgress::Updated:
+            hand.State.Target.Phase = EInteractionPhase::Ready;
+            AttachTarget(update, hand.State);
+            break;
+
+        case EGestureProgress::Lost:
+            hand.State.Target.Phase = EInteractionPhase::Pending;
+            DetachTarget(hand.State);
+            break;
+    }
+}
+
+void APPipeGrid::UpdateFocus(GridHand& hand)
+{
+    HOLOPIPES_PROFILE_SCOPE(GridFocus);
+
+    float now = GetInteractionTime();
+
+    const FPipeGridCoordinate previousCoord = hand.State.Pipe.StartCoordinate;
+    APPipe* previousPipe = hand.State.Pipe.Actor;
+
+    if (previousPipe != nullptr)
+    {
+        GridPipe* previousGridPipe = GetActionablePipe(previousCoord);
+        if (!previousGridPipe || previousGridPipe->pipe != previousPipe)
+        {
+            // We did have a pipe, but it no longer exists at that location
+            previousPipe = nullptr;
+        }
+    }
+
+    FPipeGridCoordinate toolboxHandleCoord = FPipeGridCoordinate::Zero;
+    const bool haveToolboxHandle = ToolboxCoordinateForType(EPipeType::Start, &toolboxHandleCoord);
+    const bool toolboxHandleFocused = haveToolboxHandle && hand.State.Target.Coordinate == toolboxHandleCoord;
+
+    FPipeGridCoordinate currentCoord = FPipeGridCoordinate::Zero;
+    APPipe* currentPipe = nullptr;
+
+    float currentDistSq = 0;
+
+    const FVector aabbCornerOffset = FVector(CellSize * FocusGutterRatio) / 2.0f;
+
+    // Consider all pipes near the hand to pick the best "point in time" candidate for focus
+    for (int xOffset = -1; xOffset <= 1; xOffset++)
+    {
+        for (int yOffset = -1; yOffset <= 1; yOffset++)
+        {
+            for (int zOffset = -1; zOffset <= 1; zOffset++)
+            {
+                FPipeGridCoordinate candidateCoord = hand.State.Target.Coordinate + FPipeGridCoordinate{ xOffset, yOffset, zOffset };
+                const GridPipe* candidateGridPipe = GetActionablePipe(candidateCoord);
+
+                if (candidateGridPipe && candidateGridPipe->pipe)
+                {
+                    // We have a pipe
+
+                    if (!candidateGridPipe->pipe->GetInToolbox() && !GazeNearCoordinate(candidateCoord))
+                    {
+                        // The pipe isn't in the toolbox and doesn't have gaze nearby. Ignore it for focus.
+                        // (We don't care about gaze in the toolbox because it is common to interact with the toolbox
+                        // without looking directly at it).
+#if !UE_BUILD_SHIPPING
+                        if (m_debugFocus)
+                        {
+                            
+                            // Ignore it as a focus candidate (still record it for debug visualizations)
+                            candidateGridPipe->pipe->SetFocusStage(EFocusStage::HandOnly);
+                            hand.Focus.HandOnly.push_back(candidateGridPipe->pipe);
+                        }
+#endif
+                    }
+                    else
+                    {
+
+#if !UE_BUILD_SHIPPING
+                        if (m_debugFocus)
+                        {
+                            // The pipe does have gaze nearby, so consider it as a candidate
+                            hand.Focus.HandAndGaze.push_back(candidateGridPipe->pipe);
+                        }
+#endif
+
+                        float candidateDistSq = FVector::DistSquared(hand.State.Target.Location, GridCoordinateToGridLocation(candidateCoord));
+                        bool takeCandidate = (currentPipe == nullptr || candidateDistSq < currentDistSq);
+
+                        if (takeCandidate)
+                        {
+                            // This new pipe is currently the best candidate, so take it (replacing any previous
+                            // best candidate)
+
+#if !UE_BUILD_SHIPPING
+                            if (m_debugFocus && currentPipe != nullptr)
+                            {
+                                // Mark it for visualization (as long as we're not downgrading it)
+                                if (currentPipe->GetFocusStage() != EFocusStage::HandAndGazeAndDistance)
+                                {
+                                    currentPipe->SetFocusStage(EFocusStage::HandAndGaze);
+                                }
+                            }
+#endif
+
+                            currentPipe = candidateGridPipe->pipe;
+                            currentCoord = candidateCoord;
+                            currentDistSq = candidateDistSq;
+                        }
+
+#if !UE_BUILD_SHIPPING
+                        else if (m_debugFocus)
+                        {
+                            // This new pipe isn't the best candidate, so we'll only mark it for
+                            // visualization purposes (but don't downgrade it)
+
+                            if (candidateGridPipe->pipe->GetFocusStage() != EFocusStage::HandAndGazeAndDistance)
+                            {
+                                candidateGridPipe->pipe->SetFocusStage(EFocusStage::HandAndGaze);
+                            }
+                        }
+#endif
+                    }
+                }
+            }
+        }
+    }
+
+    if (currentPipe)
+    {
+
+#if !UE_BUILD_SHIPPING
+
+        if (m_debugFocus)
+        {
+            // We haven't marked the candidate pipe yet, so mark it for visualization
+            currentPipe->SetFocusStage(EFocusStage::HandAndGazeAndDistance);
+        }
+#endif
+
+        if (toolboxHandleFocused)
+        {
+            // Clear out the current pipe if the toolbox handle is focused
+            currentPipe = nullptr;
+        }
+    }
+
+    bool pipeChanged = (currentPipe != previousPipe);
+    bool shouldKeepFocus = true;
+    bool usePrevious = false;
+
+    if (pipeChanged)
+    {
+        if (previousPipe)
+        {
+            // The neighborhood is defined as the pipe itself and its direct neighbors
+            const bool targetInPreviousNeighborhood = (hand.State.Target.Coordinate.DistanceToSq(previousCoord) <= 3.0f);
+
+            // We have a previous pipe. We should only consider using it if we're still in its same neighborhood
+            if (targetInPreviousNeighborhood)
+            {
+                // If we're focusing another pipe, or we're focusing the toolbox handle, we need to consider 
+                // whether the previous pipe should hold on to focus a little longer (ie, if it has ever shown rotate handles 
+                // and our focus has only recently changed to something else)
+                if (currentPipe || toolboxHandleFocused)
+                {
+                    // Focus isn't sticky in the toolbox
+                    if (!previousPipe->GetInToolbox())
+                    {
+                        // We want to keep focus if both fingers and gaze are still pretty close to the previous pipe
+                        const FVector previousLocation = GridCoordinateToGridLocation(previousCoord);
+                        const FVector minAABB = previousLocation - aabbCornerOffset;
+                        const FVector maxAABB = previousLocation + aabbCornerOffset;
+
+                        if (GazeNearCoordinate(previousCoord))
+                        {
+                            usePrevious = true;
+                            for (int i = 0; usePrevious && i < 3; i++)
+                            {
+                                usePrevious = (hand.State.Target.Location[i] > minAABB[i] && hand.State.Target.Location[i] < maxAABB[i]);
+                            }
+                        }
+
+                        // If we're not close enough to automatically keep focus, keep focus if we haven't timed out yet
+                        if (!usePrevious && hand.State.Debounce.ShouldKeepFocus.UpdateCurrent(false, now))
+                        {
+                            usePrevious = true;
+                            shouldKeepFocus = false;
+                        }
+                    }
+                }
+                else
+                {
+                    usePrevious = true;
+                }
+            }
+        }
+    }
+
+    if (usePrevious)
+    {
+        currentPipe = previousPipe;
+        currentCoord = previousCoord;
+        pipeChanged = false;
+    }
+
+    bool wasShowingRotateHandles = ShowingRotateHandles(hand.State);
+    EInteractionAxis previousRotateHandle = wasShowingRotateHandles ? hand.State.Rotate.CurrentAxis : EInteractionAxis::None;
+
+    if (currentPipe)
+    {
+        // We've got a current pipe, so update our state
+        hand.State.InteractionMode = InteractionMode::Focus;
+        hand.State.Pipe.Actor = currentPipe;
+        hand.State.Pipe.StartCoordinate = currentCoord;
+        hand.State.Pipe.StartDirections = hand.State.Pipe.Actor->GetPipeDirections();
+        hand.State.Pipe.StartRotation = hand.State.Pipe.Actor->GetDesiredRotation().Quaternion();
+
+        EInteractionAxis nextHandleAxis = EInteractionAxis::None;
+        FVector nextHandleLocation = FVector::ZeroVector;
+
+        if (pipeChanged)
+        {
+            hand.State.Debounce.ShouldKeepFocus.Reset();
+            hand.State.Debounce.ShouldKeepFocus.SetCurrent(true);
+
+            hand.State.Debounce.CurrentRotateAxis.Reset();
+            hand.State.Debounce.CurrentRotateAxis.SetCurrent(EInteractionAxis::None);
+
+            hand.State.Debounce.ShowRotateHandles.SetCurrent(false);
+        }
+        else
+        {
+            if (hand.State.Debounce.ShowRotateHandles.UpdateCurrent(m_rotateEnabled && !currentPipe->GetInToolbox(), now))
+            {
+                ComputeCurrentRotationHandle(currentCoord, hand.State, &nextHandleAxis, &nextHandleLocation);
+
+                if (!wasShowingRotateHandles)
+                {
+                    hand.State.Debounce.ShouldKeepFocus.Reset(LoseRotateFocusTimeout);
+                    hand.State.Debounce.ShouldKeepFocus.SetCurrent(true);
+
+                    hand.State.Debounce.CurrentRotateAxis.Reset(ChangeRotateAxisTimeout);
+                    hand.State.Debounce.CurrentRotateAxis.SetCurrent(nextHandleAxis);
+                }
+            }
+
+            if (shouldKeepFocus)
+            {
+                hand.State.Debounce.ShouldKeepFocus.SetCurrent(true);
+            }
+        }
+
+        if (nextHandleAxis == hand.State.Debounce.CurrentRotateAxis.UpdateCurrent(nextHandleAxis, now))
+        {
+            hand.State.Rotate.CurrentAxis = nextHandleAxis;
+            hand.State.Rotate.HandleLocation = nextHandleLocation;
+        }
+    }
+    else
+    {
+        // We don't have a current pipe, so clear our state
+        hand.State.Pipe = {};
+        
+        ClearHandDebounce(hand.State);
+        hand.State.Rotate.CurrentAxis = EInteractionAxis::None;
+        hand.State.Rotate.HandleLocation = FVector::ZeroVector;
+
+        // And check if we're focusing the toolbox
+
+        if (toolboxHandleFocused && !IsToolboxDragging())
+        {
+            hand.State.InteractionMode = InteractionMode::ToolboxFocus;
+            hand.State.Pipe.StartCoordinate = toolboxHandleCoord;
+        }
+        else
+        {
+            hand.State.InteractionMode = InteractionMode::None;
+        }
+    }
+
+    bool isShowingRotateHandles = ShowingRotateHandles(hand.State);
+    EInteractionAxis currentRotateHandle = isShowingRotateHandles ? hand.State.Rotate.CurrentAxis : EInteractionAxis::None;
+
+    if (currentRotateHandle != previousRotateHandle)
+    {
+        OnRotateHandleShown.Broadcast(currentRotateHandle == EInteractionAxis::None ? currentCoord : previousCoord, currentRotateHandle);
+    }
+}
+
+void APPipeGrid::HandleNoneGestureUpdate(const FFingerGestureUpdate& update, GridHand& hand)
+{
+    GridHandTarget oldTarget = hand.State.Target;
+    ClearHand(hand);
+
+    hand.State.Target = oldTarget;
+    hand.State.InteractionMode = InteractionMode::None;
+
+    switch (update.Progress)
+    {
+        case EGestureProgress::Tracked:
+        case EGestureProgress::Started:
+        case EGestureProgress::Updated:
+            UpdateFocus(hand);
+            break;
+    }
+}
+
+void APPipeGrid::HandleFocusedGestureUpdate(const FFingerGestureUpdate& update, GridHand& hand)
+{
+    switch (update.Progress)
+    {
+        case EGestureProgress::None:
+        case EGestureProgress::Lost:
+            hand.State.InteractionMode = InteractionMode::None;
+            break;
+
+        case EGestureProgress::Tracked:
+            UpdateFocus(hand);
+            break;
+
+        case EGestureProgress::Started:
+        {
+            bool handled = false;
+            if (hand.State.InteractionMode == InteractionMode::ToolboxFocus)
+            {
+                handled = TryHandleStartToolboxDrag(hand.State);
+            }
+
+            if (!handled)
+            {
+                handled = TryHandleDragStart(update, hand.State);
+            }
+
+            if (!handled)
+            {
+                handled = TryHandleRotateStart(hand.State);
+                if (handled)
+                {
+                    hand.State.Debounce.ShowRotateHandles.SetCurrent(true);
+                }
+            }
+
+
+            break;
+        }
+
+        case EGestureProgress::Updated:
+
+            UpdateFocus(hand);
+            TryHandleDragStart(update, hand.State);
+
+            // We don't allow rotation if we enter a pipe's focus area already pinched
+            hand.State.Debounce.ShowRotateHandles.SetCurrent(false);
+
+            break;
+    }
+}
+
+
+bool APPipeGrid::PipeConnected(const GridPipe& pipe, PipeDirections direction)
+{
+    bool connected = false;
+
+    PipeDirections connections = pipe.pipe->GetPipeDirections();
+    if (IsAnyFlagSet(direction, connections))
+    {
+        // This direction represents an outbound connection, see if there's a neighbor
+        FPipeGridCoordinate neighborLocation = pipe.currentLocation + APPipe::PipeDirectionToLocationAdjustment(direction);
+        auto itFind = m_pipesGrid.find(neighborLocation);
+
+        if (itFind != m_pipesGrid.end())
+        {
+            if (itFind->second.pipe && !itFind->second.pipe->GetInToolbox())
+            {
+                // There's a pipe at that location (and it's not in the toolbox), see if it connects back to us
+                if (IsAnyFlagSet(itFind->second.pipe->GetPipeDirections(), APPipe::InvertPipeDirection(direction)))
+                {
+                    // It does! We are connected
+                    connected = true;
+                }
+            }
+        }
+    }
+
+    return connected;
+}
+
+bool APPipeGrid::PipeConnected(const FPipeGridCoordinate& pipeCoordinate)
+{
+    bool connected = false;
+    auto itTarget = m_pipesGrid.find(pipeCoordinate);
+
+    if (itTarget != m_pipesGrid.end())
+    {
+        GridPipe& gridPipe = itTarget->second;
+
+        if (gridPipe.pipe && !gridPipe.pipe->GetInToolbox())
+        {
+            connected = (gridPipe.pipe->GetPipeClass() != DefaultPipeClass);
+
+            if (!connected)
+            {
+                // Pipes can be connected and still be the default pipe class if no 
+                // connected pipe is ultiamtely connected to a start or end      
+
+                for (int i = 0; !connected && i < APPipe::ValidDirectionsCount; i++)
+                {
+                    PipeDirections currentConnection = APPipe::ValidDirections[i];
+                    connected = PipeConnected(gridPipe, currentConnection);
+                }
+            }
+        }
+    }
+
+    return connected;
+}
+
+bool APPipeGrid::CheckForSolution()
+{
+    bool solution = ResolveGridChanges();
+
+    if (solution)
+    {
+        // The grid is in a solution state (ie, no disconnected pipes, no open pipe connections, 
+        // all connected pipes are in the same class, and no pipes left in the toolbox).
+        // Announce the solution.
+        OnGridSolved.Broadcast();
+    }
+    
+    return solution;
+}
+
+bool APPipeGrid::ResolveGridState()
+{
+    HOLOPIPES_PROFILE_SCOPE(GridResolve);
+
+    m_openConnections = 0;
+    m_disconnectedPipes = 0;
+    m_dirtyConnectivity.clear();
+
+    // Step 1: Setup
+    // We go through all GridPipes, adding fixed ones to
+    // the open list (with their current PipeClass), and marking all
+    // others as the default pipe class
+    auto itSetup = m_pipesGrid.begin();
+    while (itSetup != m_pipesGrid.end())
+    {
+        itSetup->second.openConnections = 0;
+        itSetup->second.disconnected = false;
+
+        if (IsConnectivityNode(itSetup->second))
+        {
+            if (itSetup->second.pipe->GetPipeFixed())
+            {
+                m_openList.push_back(&(itSetup->second));
+            }
+            else
+            {
+                itSetup->second.currentPipeClass = DefaultPipeClass;
+            }
+        }
+
+        itSetup++;
+    }
+
+    // Step 2: Walk
+    WalkOpenList();
+
+    // Step 3: Cleanup
+    // Count how many pipes are disconnected from starts/ends, and update 
+    // the class of all pipes that have changed during resolution
+    auto itCleanup = m_pipesGrid.begin();
+    while (itCleanup != m_pipesGrid.end())
+    {
+        if (itCleanup->second.pipe)
+        {
+            FinishResolvingPipe(itCleanup->second);
+        }
+
+        itCleanup++;
+    }
+
+    // Step 4:
+    // Reutrn whether we're in a solution state; that means all pipe connections are connected,
+    // all placed pipes are in a non-default class, and all pipe pieces are in the same class as their 
+    // connected neighbors
+    return IsResolvedSolution();
+}
+
+bool APPipeGrid::IsConnectivityNode(const GridPipe& gridPipe)
+{
+    return gridPipe.pipe && !gridPipe.pipe->GetInToolbox() && gridPipe.pipe->GetPipeType() != EPipeType::Block;
+}
+
+void APPipeGrid::WalkOpenList()
+{
+    // As long as the open list isn't empty, pick off the first item. 
+    // Iterate that item's outbound connections and:
+    //   * If that connection has a connected neighbor:
+    //     * If the neighbor is still in the Default class, add it to this piece's class and stick in in the open list
+    //     * If the neighbor is already in the same class, ignore it
+    //     * If the neighbor is in a different class, treat it as an open connection and increment the open connections count
+    //   * If that connection has no connected neighbor, increment the open connections count
+    while (!m_openList.empty())
+    {
+        GridPipe* gridPipe = m_openList.front();
+        m_openList.pop_front();
+
+        PipeDirections connections = gridPipe->pipe->GetPipeDirections();
+        int openConnections = 0;
+
+        for (int i = 0; i < APPipe::ValidDirectionsCount; i++)
+        {
+            PipeDirections currentConnection = APPipe::ValidDirections[i];
+            if (IsAnyFlagSet(connections, currentConnection))
+            {
+                // This direction represents an outbound connection, see if there's a neighbor
+                FPipeGridCoordinate neighborLocation = gridPipe->currentLocation + APPipe::PipeDirectionToLocationAdjustment(currentConnection);
+
+                auto itFind = m_pipesGrid.find(neighborLocation);
+
+                if (itFind == m_pipesGrid.end() || !itFind->second.pipe)
+                {
+                    // There's no pipe at that location, so it's an open connection
+                    openConnections++;
+                }
+
+                else if (!itFind->second.pipe || itFind->second.pipe->GetInToolbox())
+                {
+                    // The neighbor is null or is in the toolbox, so it's disconnected by definition
+                    openConnections++;
+                }
+
+                // Ignore pipes that are already in our class
+                else if (itFind->second.currentPipeClass == gridPipe->currentPipeClass)
+                {
+                    // The neighbor is in our class. Make sure it has a connection back to us
+                    if (!IsAnyFlagSet(itFind->second.pipe->GetPipeDirections(), APPipe::InvertPipeDirection(currentConnection)))
+                    {
+                        // It doesn't, so this is an open connection
+                        openConnections++;
+                    }
+                }
+                else
+                {
+                    // The neighbor isn't in our class
+                    if (itFind->second.currentPipeClass != DefaultPipeClass)
+                    {
+                        // The neighbor is already in a class, so it counts as an open connection
+                        openConnections++;
+                    }
+                    else
+                    {
+                        // The neighbor pipe can be added to our class. Make sure it has a connection back to us
+                        if (!IsAnyFlagSet(itFind->second.pipe->GetPipeDirections(), APPipe::InvertPipeDirection(currentConnection)))
+                        {
+                            // It doesn't, so this is an open connection
+                            openConnections++;
+                        }
+                        else
+                        {
+                            // It does! Add it to our class and add it to the open list
+                            itFind->second.currentPipeClass = gridPipe->currentPipeClass;
+                            m_openList.push_back(&itFind->second);
+                        }
+                    }
+                }
+            }
+        }
+
+        gridPipe->openConnections = openConnections;
+        m_openConnections += openConnections;
+
+        gridPipe->pipe->SetShowLabel(openConnections > 0 && m_labelsEnabled);
+    }
+}
+
+void APPipeGrid::FinishResolvingPipe(GridPipe& gridPipe)
+{
+    HOLOPIPES_PROFILE_COUNT(PipesResolved, 1);
+
+    if (gridPipe.currentPipeClass == DefaultPipeClass)
+    {
+        gridPipe.pipe->SetShowLabel(false);
+
+        if (!gridPipe.pipe->GetInToolbox() && gridPipe.pipe->GetPipeType() != EPipeType::Block)
+        {
+            gridPipe.disconnected = true;
+            m_disconnectedPipes++;
+        }
+    }
+
+    if (gridPipe.currentPipeClass != gridPipe.pipe->GetPipeClass())
+    {
+        gridPipe.pipe->SetPipeClass(gridPipe.currentPipeClass);
+    }
+
+    IndexPipe(gridPipe);
+}
+
+bool APPipeGrid::IsResolvedSolution()
+{
+    int disconnectedPipes = m_disconnectedPipes;
+
+    // Any pipe we're currently dragging is disconnected by definition
+    if (m_hands.Left.State.InteractionMode == InteractionMode::Translate && m_hands.Left.State.Pipe.Actor != nullptr)
+    {
+        disconnectedPipes++;
+    }
+    if (m_hands.Right.State.InteractionMode == InteractionMode::Translate && m_hands.Right.State.Pipe.Actor != nullptr)
+    {
+        disconnectedPipes++;
+    }
+
+    return (m_openConnections == 0 && disconnectedPipes == 0);
+}
+
+void APPipeGrid::MarkConnectivityDirty(const FPipeGridCoordinate& coordinate)
+{
+    // The pipe here may be about to go away, so take its share out of the totals now. Everything
+    // else the change can affect is connected to this coordinate or one of its neighbors, and gets
+    // picked up by ResolveGridChanges
+    auto it = m_pipesGrid.find(coordinate);
+    if (it != m_pipesGrid.end())
+    {
+        m_openConnections -= it->second.openConnections;
+        m_disconnectedPipes -= (it->second.disconnected ? 1 : 0);
+
+        it->second.openConnections = 0;
+        it->second.disconnected = false;
+    }
+
+    m_dirtyConnectivity.push_back(coordinate);
+    m_connectivityGeneration++;
+}
+
+bool APPipeGrid::ResolveGridChanges()
+{
+    HOLOPIPES_PROFILE_SCOPE(GridResolve);
+
+    if (IsAsyncResolvePending())
+    {
+        // The grid is only partly resolved until the async resolve lands, and that will pick these
+        // changes up (see UpdateAsyncResolve)
+        m_asyncResolve.ChangesDeferred = m_asyncResolve.ChangesDeferred || !m_dirtyConnectivity.empty();
+        return false;
+    }
+
+    if (!m_dirtyConnectivity.empty())
+    {
+        m_resolveStamp++;
+
+        for (const FPipeGridCoordinate& dirty : m_dirtyConnectivity)
+        {
+            // -1 is the dirty coordinate itself, the rest are its neighbors
+            for (int i = -1; i < APPipe::ValidDirectionsCount; i++)
+            {
+                FPipeGridCoordinate seed = dirty;
+                if (i >= 0)
+                {
+                    seed += APPipe::PipeDirectionToLocationAdjustment(APPipe::ValidDirections[i]);
+                }
+
+                auto itSeed = m_pipesGrid.find(seed);
+                if (itSeed != m_pipesGrid.end() && IsConnectivityNode(itSeed->second) && itSeed->second.resolveStamp != m_resolveStamp)
+                {
+                    ResolveComponent(itSeed->second);
+                }
+            }
+        }
+
+        m_dirtyConnectivity.clear();
+    }
+
+#if !UE_BUILD_SHIPPING
+    if (m_debugResolve)
+    {
+        VerifyIncrementalResolve();
+        VerifyPipeSets();
+    }
+#endif
+
+    return IsResolvedSolution();
+}
+
+void APPipeGrid::ResolveComponent(GridPipe& first)
+{
+    // Gather every pipe joined to this one by connections that meet from both sides. Nothing
+    // outside of that group can change class because of it, and it only sees the group's pipes
+    // as open connections
+    m_resolveComponent.clear();
+    m_resolveComponent.push_back(&first);
+    first.resolveStamp = m_resolveStamp;
+
+    for (size_t i = 0; i < m_resolveComponent.size(); i++)
+    {
+        GridPipe* gridPipe = m_resolveComponent[i];
+        PipeDirections connections = gridPipe->pipe->GetPipeDirections();
+
+        for (int j = 0; j < APPipe::ValidDirectionsCount; j++)
+        {
+            PipeDirections currentConnection = APPipe::ValidDirections[j];
+            if (IsAnyFlagSet(connections, currentConnection))
+            {
+                auto itFind = m_pipesGrid.find(gridPipe->currentLocation + APPipe::PipeDirectionToLocationAdjustment(currentConnection));
+
+                if (itFind != m_pipesGrid.end() &&
+                    itFind->second.resolveStamp != m_resolveStamp &&
+                    IsConnectivityNode(itFind->second) &&
+                    IsAnyFlagSet(itFind->second.pipe->GetPipeDirections(), APPipe::InvertPipeDirection(currentConnection)))
+                {
+                    itFind->second.resolveStamp = m_resolveStamp;
+                    m_resolveComponent.push_back(&itFind->second);
+                }
+            }
+        }
+    }
+
+    // Seed the walk with the group's fixed pipes in the order ResolveGridState would find them, so
+    // a group holding more than one class gets split the same way. The grid storage is packed, so
+    // that's address order
+    std::sort(m_resolveComponent.begin(), m_resolveComponent.end());
+
+    for (GridPipe* gridPipe : m_resolveComponent)
+    {
+        m_openConnections -= gridPipe->openConnections;
+        m_disconnectedPipes -= (gridPipe->disconnected ? 1 : 0);
+
+        gridPipe->openConnections = 0;
+        gridPipe->disconnected = false;
+
+        if (gridPipe->pipe->GetPipeFixed())
+        {
+            m_openList.push_back(gridPipe);
+        }
+        else
+        {
+            gridPipe->currentPipeClass = DefaultPipeClass;
+        }
+    }
+
+    WalkOpenList();
+
+    for (GridPipe* gridPipe : m_resolveComponent)
+    {
+        FinishResolvingPipe(*gridPipe);
+    }
+}
+
+void APPipeGrid::SetLabelsEnabled(bool enabled)
+{
+    if (m_labelsEnabled != enabled)
+    {
+        m_labelsEnabled = enabled;
+        ResolveGridStateAsync();
+    }
+}
+
+bool APPipeGrid::GetLabelsEnabled()
+{
+    return m_labelsEnabled;
+}
+
+
+bool APPipeGrid::ToggleDebugFocus()
+{
+#if UE_BUILD_SHIPPING
+    return false;
+#else
+    m_debugFocus = !m_debugFocus;
+    return true;
+#endif
+}
+bool APPipeGrid::ToggleDebugResolve()
+{
+#if UE_BUILD_SHIPPING
+    return false;
+#else
+    m_debugResolve = !m_debugResolve;
+    return true;
+#endif
+}
+
+#if !UE_BUILD_SHIPPING
+bool APPipeGrid::VerifyIncrementalResolve()
+{
+    const int incrementalOpen = m_openConnections;
+    const int incrementalDisconnected = m_disconnectedPipes;
+
+    std::vector<std::pair<FPipeGridCoordinate, int>> incrementalClasses;
+    for (auto& entry : m_pipesGrid)
+    {
+        if (IsConnectivityNode(entry.second))
+        {
+            incrementalClasses.push_back({ entry.first, entry.second.currentPipeClass });
+        }
+    }
+
+    ResolveGridState();
+
+    bool agree = (incrementalDisconnected == m_disconnectedPipes);
+    bool classesMatch = true;
+
+    for (const auto& incremental : incrementalClasses)
+    {
+        const int fullClass = m_pipesGrid.find(incremental.first)->second.currentPipeClass;
+        if (fullClass != incremental.second)
+        {
+            classesMatch = false;
+
+            // Which of several classes a pipe ends up in can depend on the order pipes were added,
+            // but whether it's connected to anything at all can't
+            if (fullClass == DefaultPipeClass || incremental.second == DefaultPipeClass)
+            {
+                UE_LOG(HoloPipesLog, Error, L"APPipeGrid::VerifyIncrementalResolve - Pipe at {%d, %d, %d} is class %d, expected %d",
+                    incremental.first.X, incremental.first.Y, incremental.first.Z, incremental.second, fullClass);
+                agree = false;
+            }
+        }
+    }
+
+    // The open connection count follows from the classes, so it has to match when they do. When
+    // they don't, some group of pipes reaches more than one class and there are open connections
+    // either way
+    if (classesMatch ? (incrementalOpen != m_openConnections) : (incrementalOpen == 0 || m_openConnections == 0))
+    {
+        agree = false;
+    }
+
+    if (!agree)
+    {
+        UE_LOG(HoloPipesLog, Error, L"APPipeGrid::VerifyIncrementalResolve - Incremental resolve found %d open and %d disconnected, full resolve found %d open and %d disconnected",
+            incrementalOpen, incrementalDisconnected, m_openConnections, m_disconnectedPipes);
+    }
+
+    return agree;
+}
+
+bool APPipeGrid::VerifyPipeSets()
+{
+    bool agree = true;
+    size_t expectedSizes[static_cast<int>(GridPipeSet::Count)] = {};
+
+    for (auto& entry : m_pipesGrid)
+    {
+        // Work out which sets the pipe belongs in from scratch
+        APPipe* pipe = entry.second.pipe;
+        const bool fixed = pipe && pipe->GetPipeFixed();
+        const bool inToolbox = pipe && !fixed && pipe->GetInToolbox();
+        const bool placed = pipe && !fixed && !inToolbox;
+        const bool member[] = { placed, inToolbox, fixed, placed && pipe->GetPipeClass() == DefaultPipeClass };
+
+        for (int set = 0; set < static_cast<int>(GridPipeSet::Count); set++)
+        {
+            const std::vector<FPipeGridCoordinate>& pipeSet = m_pipeSets[set];
+            const int32 index = entry.second.setIndex[set];
+            const bool indexed = (index >= 0 && index < static_cast<int32>(pipeSet.size()) && pipeSet[index] == entry.first);
+
+            if (member[set] != indexed || (!member[set] && index >= 0))
+            {
+                UE_LOG(HoloPipesLog, Error, L"APPipeGrid::VerifyPipeSets - Pipe at {%d, %d, %d} should %sbe in set %d",
+                    entry.first.X, entry.first.Y, entry.first.Z, (member[set] ? L"" : L"not "), set);
+                agree = false;
+            }
+
+            expectedSizes[set] += member[set] ? 1 : 0;
+        }
+    }
+
+    for (int set = 0; set < static_cast<int>(GridPipeSet::Count); set++)
+    {
+        if (m_pipeSets[set].size() != expectedSizes[set])
+        {
+            UE_LOG(HoloPipesLog, Error, L"APPipeGrid::VerifyPipeSets - Set %d has %d pipes, expected %d",
+                set, static_cast<int32>(m_pipeSets[set].size()), static_cast<int32>(expectedSizes[set]));
+            agree = false;
+        }
+    }
+
+    return agree;
+}
+
+#endif
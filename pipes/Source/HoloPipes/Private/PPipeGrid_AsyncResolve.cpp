@@ -0,0 +1,356 @@
+
+#include "PPipeGrid_Internal.h"
+#include "Async/Async.h"
+#include "Async/ParallelFor.h"
+#include <algorithm>
+#include <atomic>
+
+namespace
+{
+    int32 FindRoot(std::vector<std::atomic<int32>>& parents, int32 node)
+    {
+        int32 parent = parents[node].load(std::memory_order_relaxed);
+        while (parent != node)
+        {
+            node = parent;
+            parent = parents[node].load(std::memory_order_relaxed);
+        }
+
+        return node;
+    }
+
+    // Joins the sets holding a and b. Roots only ever point at lower roots, so there are no cycles,
+    // and a failed swap means another thread moved the root first and we look again
+    void Unite(std::vector<std::atomic<int32>>& parents, int32 a, int32 b)
+    {
+        while (true)
+        {
+            int32 rootA = FindRoot(parents, a);
+            int32 rootB = FindRoot(parents, b);
+
+            if (rootA == rootB)
+            {
+                return;
+            }
+
+            if (rootA > rootB)
+            {
+                std::swap(rootA, rootB);
+            }
+
+            int32 expected = rootB;
+            if (parents[rootB].compare_exchange_weak(expected, rootA, std::memory_order_relaxed))
+            {
+                return;
+            }
+        }
+    }
+}
+
+void AsyncResolveJob::Run()
+{
+    HOLOPIPES_PROFILE_SCOPE(GridResolveWorker);
+
+    const int32 count = static_cast<int32>(Coordinates.size());
+    const int32 directionCount = APPipe::ValidDirectionsCount;
+
+    // Step 1: Links
+    // Sort the nodes by coordinate so any thread can look up a neighbor, then find each node's
+    // neighbor in every direction where the connection meets one coming back. Anything else that
+    // connection could lead to (nothing, a block, a pipe in the toolbox) makes it open
+    std::vector<std::pair<size_t, int32>> sorted(count);
+    for (int32 i = 0; i < count; i++)
+    {
+        sorted[i] = { FPipeGridCoordinate::HashOf(Coordinates[i]), i };
+    }
+
+    std::sort(sorted.begin(), sorted.end());
+
+    std::vector<int32> links(static_cast<size_t>(count) * directionCount, -1);
+
+    ParallelFor(count, [&](int32 i)
+    {
+        for (int32 j = 0; j < directionCount; j++)
+        {
+            PipeDirections direction = APPipe::ValidDirections[j];
+            if (IsAnyFlagSet(Directions[i], direction))
+            {
+                size_t key = FPipeGridCoordinate::HashOf(Coordinates[i] + APPipe::PipeDirectionToLocationAdjustment(direction));
+
+                auto itFind = std::lower_bound(sorted.begin(), sorted.end(), std::make_pair(key, static_cast<int32>(-1)));
+                if (itFind != sorted.end() && itFind->first == key &&
+                    IsAnyFlagSet(Directions[itFind->second], APPipe::InvertPipeDirection(direction)))
+                {
+                    links[i * directionCount + j] = itFind->second;
+                }
+            }
+        }
+    });
+
+    // Step 2: Components
+    // Union-find over the links. Each component keeps its nodes in storage order
+    std::vector<std::atomic<int32>> parents(count);
+    ParallelFor(count, [&](int32 i)
+    {
+        parents[i].store(i, std::memory_order_relaxed);
+    });
+
+    ParallelFor(count, [&](int32 i)
+    {
+        for (int32 j = 0; j < directionCount; j++)
+        {
+            int32 neighbor = links[i * directionCount + j];
+            if (neighbor > i)
+            {
+                Unite(parents, i, neighbor);
+            }
+        }
+    });
+
+    std::vector<int32> componentOf(count);
+    ParallelFor(count, [&](int32 i)
+    {
+        componentOf[i] = FindRoot(parents, i);
+    });
+
+    // Every root is the lowest node in its component, so numbering the roots in order and looking
+    // the rest up goes in one pass
+    std::vector<int32> componentStart(1, 0);
+    for (int32 i = 0; i < count; i++)
+    {
+        if (componentOf[i] == i)
+        {
+            componentOf[i] = static_cast<int32>(componentStart.size()) - 1;
+            componentStart.push_back(0);
+        }
+        else
+        {
+            componentOf[i] = componentOf[componentOf[i]];
+        }
+
+        componentStart[componentOf[i] + 1]++;
+    }
+
+    ComponentCount = static_cast<int32>(componentStart.size()) - 1;
+
+    for (int32 c = 0; c < ComponentCount; c++)
+    {
+        componentStart[c + 1] += componentStart[c];
+    }
+
+    std::vector<int32> members(count);
+    {
+        std::vector<int32> next(componentStart.begin(), componentStart.end() - 1);
+        for (int32 i = 0; i < count; i++)
+        {
+            members[next[componentOf[i]]++] = i;
+        }
+    }
+
+    // Step 3: Walk
+    // The same walk as APPipeGrid::WalkOpenList, one component at a time. A walk never crosses a link
+    // between components, so walking each from its own fixed pipes, in storage order, gives every
+    // pipe the class and open connections the walk over the whole grid would
+    OpenConnections.assign(count, 0);
+    Reached.assign(count, 0);
+
+    std::atomic<int32> totalOpenConnections(0);
+
+    ParallelFor(ComponentCount, [&](int32 c)
+    {
+        std::vector<int32> openList;
+        for (int32 m = componentStart[c]; m < componentStart[c + 1]; m++)
+        {
+            if (Fixed[members[m]])
+            {
+                openList.push_back(members[m]);
+            }
+        }
+
+        int32 componentOpenConnections = 0;
+
+        for (size_t head = 0; head < openList.size(); head++)
+        {
+            int32 node = openList[head];
+            int32 openConnections = 0;
+
+            for (int32 j = 0; j < directionCount; j++)
+            {
+                if (IsAnyFlagSet(Directions[node], APPipe::ValidDirections[j]))
+                {
+                    int32 neighbor = links[node * directionCount + j];
+
+                    if (neighbor < 0)
+                    {
+                        openConnections++;
+                    }
+                    else if (Classes[neighbor] == Classes[node])
+                    {
+                        // Already in our class
+                    }
+                    else if (Classes[neighbor] != DefaultPipeClass)
+                    {
+                        openConnections++;
+                    }
+                    else
+                    {
+                        Classes[neighbor] = Classes[node];
+                        openList.push_back(neighbor);
+                    }
+                }
+            }
+
+            OpenConnections[node] = openConnections;
+            Reached[node] = 1;
+            componentOpenConnections += openConnections;
+        }
+
+        totalOpenConnections.fetch_add(componentOpenConnections, std::memory_order_relaxed);
+    });
+
+    TotalOpenConnections = totalOpenConnections.load();
+}
+
+void APPipeGrid::ResolveGridStateAsync()
+{
+    if (AsyncResolveMinPipes <= 0 || static_cast<int32>(m_pipesGrid.size()) < AsyncResolveMinPipes)
+    {
+        bool changesDeferred = m_asyncResolve.ChangesDeferred;
+
+        CancelAsyncResolve();
+        ResolveGridState();
+
+        if (changesDeferred)
+        {
+            CheckForSolution();
+        }
+
+        return;
+    }
+
+    HOLOPIPES_PROFILE_SCOPE(GridResolveSnapshot);
+
+    TSharedPtr<AsyncResolveJob, ESPMode::ThreadSafe> job = MakeShared<AsyncResolveJob, ESPMode::ThreadSafe>();
+    job->Generation = m_connectivityGeneration;
+
+    for (const auto& entry : m_pipesGrid)
+    {
+        if (IsConnectivityNode(entry.second))
+        {
+            bool fixed = entry.second.pipe->GetPipeFixed();
+
+            job->Coordinates.push_back(entry.first);
+            job->Directions.push_back(entry.second.pipe->GetPipeDirections());
+            job->Fixed.push_back(fixed ? 1 : 0);
+            job->Classes.push_back(fixed ? entry.second.currentPipeClass : DefaultPipeClass);
+        }
+    }
+
+    // The job resolves the whole grid, which covers anything marked so far
+    m_dirtyConnectivity.clear();
+
+    // The job only touches its own copy, and keeps itself alive until it's done, so it can be
+    // dropped at any time without waiting for it
+    m_asyncResolve.Job = job;
+    m_asyncResolve.Task = Async(EAsyncExecution::ThreadPool, [job]()
+    {
+        job->Run();
+    });
+}
+
+bool APPipeGrid::IsAsyncResolvePending()
+{
+    return m_asyncResolve.Job.IsValid();
+}
+
+void APPipeGrid::UpdateAsyncResolve(bool wait)
+{
+    while (m_asyncResolve.Job.IsValid())
+    {
+        if (wait)
+        {
+            m_asyncResolve.Task.Wait();
+        }
+        else if (!m_asyncResolve.Task.IsReady())
+        {
+            return;
+        }
+
+        TSharedPtr<AsyncResolveJob, ESPMode::ThreadSafe> job = m_asyncResolve.Job;
+        m_asyncResolve.Job.Reset();
+        m_asyncResolve.Task = TFuture<void>();
+
+        if (job->Generation != m_connectivityGeneration)
+        {
+            // The grid changed under the job, so none of it can be trusted. Take another copy
+            ResolveGridStateAsync();
+            continue;
+        }
+
+        ApplyAsyncResolve(*job);
+    }
+}
+
+void APPipeGrid::ApplyAsyncResolve(const AsyncResolveJob& job)
+{
+    {
+        HOLOPIPES_PROFILE_SCOPE(GridResolveApply);
+
+        m_openConnections = job.TotalOpenConnections;
+        m_disconnectedPipes = 0;
+        m_dirtyConnectivity.clear();
+
+        for (auto& entry : m_pipesGrid)
+        {
+            entry.second.openConnections = 0;
+            entry.second.disconnected = false;
+        }
+
+        // Nothing has been added, removed or rotated since the copy was taken, so every node is where
+        // the job found it
+        for (size_t i = 0; i < job.Coordinates.size(); i++)
+        {
+            GridPipe& gridPipe = m_pipesGrid.find(job.Coordinates[i])->second;
+            gridPipe.currentPipeClass = job.Classes[i];
+            gridPipe.openConnections = job.OpenConnections[i];
+
+            if (job.Reached[i])
+            {
+                gridPipe.pipe->SetShowLabel(job.OpenConnections[i] > 0 && m_labelsEnabled);
+            }
+        }
+
+        for (auto& entry : m_pipesGrid)
+        {
+            if (entry.second.pipe)
+            {
+                FinishResolvingPipe(entry.second);
+            }
+        }
+    }
+
+    UE_LOG(HoloPipesLog, Display, L"APPipeGrid - Resolved %d pipes in %d groups off the game thread", static_cast<int32>(job.Coordinates.size()), job.ComponentCount);
+
+#if !UE_BUILD_SHIPPING
+    if (m_debugResolve)
+    {
+        VerifyIncrementalResolve();
+        VerifyPipeSets();
+    }
+#endif
+
+    // Changes made while the job ran were resolved along with everything else, and announced
+    // already. Check for the solution they'd have checked for
+    if (m_asyncResolve.ChangesDeferred)
+    {
+        m_asyncResolve.ChangesDeferred = false;
+        CheckForSolution();
+    }
+}
+
+void APPipeGrid::CancelAsyncResolve()
+{
+    m_asyncResolve.Job.Reset();
+    m_asyncResolve.Task = TFuture<void>();
+    m_asyncResolve.ChangesDeferred = false;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include "PPipe.h"
+#include "Async/Future.h"
+#include "Templates/SharedPointer.h"
+#include <vector>
+
+// A full resolve of the grid, run on worker threads. The grid copies what the resolve needs from its
+// connectivity nodes (see APPipeGrid::IsConnectivityNode) on the game thread, in storage order, and
+// applies the classes and open connections that come back on a later tick
+struct AsyncResolveJob
+{
+    // The grid's connectivity generation when the copy was taken. A result from any other
+    // generation is out of date
+    uint32 Generation = 0;
+
+    // One of each per connectivity node. Fixed pipes keep their class, and the rest start out in
+    // the default class
+    std::vector<FPipeGridCoordinate> Coordinates;
+    std::vector<PipeDirections> Directions;
+    std::vector<uint8> Fixed;
+    std::vector<int32> Classes;
+
+    // Filled in by the workers. Reached is set for the pipes the walk from the fixed pipes got to,
+    // which are the ones ResolveGridState would have shown or hidden the label of
+    std::vector<int32> OpenConnections;
+    std::vector<uint8> Reached;
+    int32 TotalOpenConnections = 0;
+
+    // The connected groups the nodes fell into, for the log
+    int32 ComponentCount = 0;
+
+    void Run();
+};
+
+struct AsyncResolveState
+{
+    TSharedPtr<AsyncResolveJob, ESPMode::ThreadSafe> Job;
+    TFuture<void> Task;
+
+    // Changes were made while the job ran, so the solution check they'd have made is owed
+    bool ChangesDeferred = false;
+};
@@ -1,176 +1,438 @@
-
-#include "PPipeGrid_Internal.h"
-
-void APPipeGrid::UpdateGaze(const FGazeUpdate& worldSpaceGaze)
-{
-    m_gaze.Origin = WorldLocationToGridLocation(worldSpaceGaze.Origin);
-    m_gaze.Direction = GetActorTransform().Inverse().TransformVectorNoScale(worldSpaceGaze.Direction);
-}
-
-bool APPipeGrid::GazeIntersectsCoordinate(const FPipeGridCoordinate& coordinate, FVector* position)
-{
-    const float halfCell = CellSize / 2.0f;
-    const FVector halfCellVector = FVector(halfCell);
-    const FVector coordinatePosition = GridCoordinateToGridLocation(coordinate);
-
-    return GazeIntersectsAABB(coordinatePosition - halfCellVector, coordinatePosition + halfCellVector, position);
-}
-
-constexpr int VectorDimCount = 3;
-
-enum class Quadrant
-{
-    Right,
-    Left,
-    Middle
-};
-
-bool APPipeGrid::GazeIntersectsAABB(const FVector& minAABB, const FVector& maxAABB, FVector* position)
-{
-    bool intersects = false;
-    FVector candidatePosition = { 0,0,0 };
-
-    // Adapted from "Fast Ray-Box Intersection" by Andrew Woo - "Graphics Gems", Academic Press, 1990
-    bool inside = true;
-    Quadrant quadrant[VectorDimCount] = {};
-    float candidatePlane[VectorDimCount] = {};
-
-    // Find candidate planes
-    for (int i = 0; i < VectorDimCount; i++)
-    {
-        if (m_gaze.Origin[i] < minAABB[i])
-        {
-            quadrant[i] = Quadrant::Left;
-            candidatePlane[i] = minAABB[i];
-            inside = false;
-        }
-        else if (m_gaze.Origin[i] > maxAABB[i])
-        {
-            quadrant[i] = Quadrant::Right;
-            candidatePlane[i] = maxAABB[i];
-            inside = false;
-        }
-        else
-        {
-            quadrant[i] = Quadrant::Middle;
-            candidatePlane[i] = 0;
-        }
-    }
-
-    if (inside)
-    {
-        // Short circuit if ray cast from inside box (we know it intersets). This
-        // produces an inaccurate intersection point, so revisit if that becomes
-        // an issue
-        candidatePosition = m_gaze.Origin;
-        intersects = true;
-    }
-    else
-    {
-        // Calculate T distances to candidate planes
-        float maxT[VectorDimCount] = {};
-        for (int i = 0; i < VectorDimCount; i++)
-        {
-            if (quadrant[i] != Quadrant::Middle && m_gaze.Direction[i] != 0)
-            {
-                maxT[i] = (candidatePlane[i] - m_gaze.Origin[i]) / m_gaze.Direction[i];
-            }
-            else
-            {
-                maxT[i] = -1.0f;
-            }
-        }
-
-        // Get the largest of the maxT's for the final choice of intersection
-        int maxPlane = 0;
-        for (int i = 1; i < VectorDimCount; i++)
-        {
-            if (maxT[maxPlane] < maxT[i])
-            {
-                maxPlane = i;
-            }
-        }
-
-        // Check final candidate actually inside box
-        if (maxT[maxPlane] >= 0)
-        {
-            intersects = true;
-            for (int i = 0; intersects && i < VectorDimCount; i++)
-            {
-                if (maxPlane == i)
-                {
-                    candidatePosition[i] = candidatePlane[i];
-                }
-                else
-                {
-                    float pos = m_gaze.Origin[i] + (maxT[maxPlane] * m_gaze.Direction[i]);;
-                    if (pos < minAABB[i] || pos > maxAABB[i])
-                    {
-                        intersects = false;
-                    }
-                    else
-                    {
-                        candidatePosition[i];
-                    }
-                }
-            }
-        }
-        
-    }
-
-    (*position) = intersects ? candidatePosition : FVector(0, 0, 0);
-    return intersects;
-
-}
-
-bool APPipeGrid::FindMinDistanceFromGaze(const FVector& position, float* distance)
-{
-    float distanceSq = 0;
-    if (FindMinDistanceFromGazeSq(position, &distanceSq))
-    {
-        (*distance) = sqrt(distanceSq);
-        return true;
-    }
-
-    return false;
-}
-
-bool APPipeGrid::FindMinDistanceFromGazeSq(const FVector& position, float* distance)
-{
-    const FVector originToPosition = (position - m_gaze.Origin);
-    const float originToPositionLengthSq = originToPosition.SizeSquared();
-
-    // Compute distance along gaze to point closest to position
-    float closestDistanceAlongGaze = FVector::DotProduct(originToPosition, m_gaze.Direction);
-
-    // A negative distance means the position is behind us, and therefore not interesting
-    if (closestDistanceAlongGaze > 0)
-    {
-        (*distance) = FVector::DistSquared(m_gaze.Origin + (m_gaze.Direction * closestDistanceAlongGaze), position);
-        return true;
-    }
-
-
-    return false;
-}
-
-void APPipeGrid::MarkPipesForGaze(MarkPipesForGazeMode mode)
-{
-    for (auto& entry : m_pipesGrid)
-    {
-        if (entry.second.pipe && !entry.second.pipe->GetPipeFixed() && !RotateEngaged(entry.first))
-        {
-            if (mode == MarkPipesForGazeMode::ClearAll)
-            {
-                entry.second.pipe->SetFocusStage(EFocusStage::None);
-            }
-            else
-            {
-                FVector position;
-                entry.second.pipe->SetFocusStage(GazeIntersectsCoordinate(entry.first, &position) ? EFocusStage::HandAndGaze : EFocusStage::None);
-            }
-        }
-    }
-
-    
-}
+
+#include "PPipeGrid_Internal.h"
+#include <algorithm>
+
+constexpr int VectorDimCount = 3;
+
+void APPipeGrid::UpdateGaze(const FGazeUpdate& worldSpaceGaze)
+{
+    m_gaze.Origin = WorldLocationToGridLocation(worldSpaceGaze.Origin);
+    m_gaze.Direction = GetWorldToGrid().TransformVectorNoScale(worldSpaceGaze.Direction);
+
+    TraverseGaze(m_playBoundsMin, m_playBoundsMax);
+}
+
+namespace
+{
+    bool CoordinateLess(const FPipeGridCoordinate& lhs, const FPipeGridCoordinate& rhs)
+    {
+        if (lhs.X != rhs.X)
+        {
+            return lhs.X < rhs.X;
+        }
+
+        if (lhs.Y != rhs.Y)
+        {
+            return lhs.Y < rhs.Y;
+        }
+
+        return lhs.Z < rhs.Z;
+    }
+
+    bool CoordinateWithin(const FPipeGridCoordinate& coordinate, const FPipeGridCoordinate& min, const FPipeGridCoordinate& max)
+    {
+        return (coordinate.X >= min.X && coordinate.X <= max.X &&
+                coordinate.Y >= min.Y && coordinate.Y <= max.Y &&
+                coordinate.Z >= min.Z && coordinate.Z <= max.Z);
+    }
+}
+
+void APPipeGrid::TraverseGaze(const FPipeGridCoordinate& boundsMin, const FPipeGridCoordinate& boundsMax)
+{
+    m_gazeCells.clear();
+    m_gazeCellLookup.clear();
+    m_gazeTraversed.clear();
+    m_haveGazeCells = false;
+
+    // The bounds are empty until a level sets up the play area
+    if (CellSize <= 0.0f || m_gaze.Direction.IsNearlyZero() ||
+        boundsMin.X > boundsMax.X || boundsMin.Y > boundsMax.Y || boundsMin.Z > boundsMax.Z)
+    {
+        return;
+    }
+
+    m_gazeBoundsMin = boundsMin;
+    m_gazeBoundsMax = boundsMax;
+
+    // From here on, the lists are authoritative for everything inside the bounds, even if the ray misses them
+    m_haveGazeCells = true;
+
+    // Work in cell units, where the cell at coordinate c spans c - 0.5 to c + 0.5 on each axis
+    const float origin[VectorDimCount] = { m_gaze.Origin.X / CellSize, m_gaze.Origin.Y / CellSize, m_gaze.Origin.Z / CellSize };
+    const float direction[VectorDimCount] = { m_gaze.Direction.X, m_gaze.Direction.Y, m_gaze.Direction.Z };
+
+    // The gutter reaches this many whole cells past a cell's own faces, so a cell can only be near
+    // the ray if the ray passes through a cell within that distance of it
+    const float gutterHalfSize = FMath::Max(0.0f, FocusGutterRatio / 2.0f);
+    const int reach = FMath::Max(0, FMath::CeilToInt(gutterHalfSize - 0.5f));
+
+    // Traverse the bounds grown by that much, so the gutters of cells on the edge are covered too
+    const int boundsMin[VectorDimCount] = { m_gazeBoundsMin.X - reach, m_gazeBoundsMin.Y - reach, m_gazeBoundsMin.Z - reach };
+    const int boundsMax[VectorDimCount] = { m_gazeBoundsMax.X + reach, m_gazeBoundsMax.Y + reach, m_gazeBoundsMax.Z + reach };
+
+    // Clip the ray to them
+    float tEnter = 0.0f;
+    float tExit = FLT_MAX;
+
+    for (int i = 0; i < VectorDimCount; i++)
+    {
+        const float low = boundsMin[i] - 0.5f;
+        const float high = boundsMax[i] + 0.5f;
+
+        if (direction[i] == 0.0f)
+        {
+            if (origin[i] < low || origin[i] > high)
+            {
+                return;
+            }
+        }
+        else
+        {
+            float t0 = (low - origin[i]) / direction[i];
+            float t1 = (high - origin[i]) / direction[i];
+            if (t0 > t1)
+            {
+                std::swap(t0, t1);
+            }
+
+            tEnter = FMath::Max(tEnter, t0);
+            tExit = FMath::Min(tExit, t1);
+        }
+    }
+
+    if (tEnter > tExit)
+    {
+        return;
+    }
+
+    // Step through the cells along the ray, as described in "A Fast Voxel Traversal Algorithm for
+    // Ray Tracing" by John Amanatides and Andrew Woo - Eurographics, 1987
+    int cell[VectorDimCount] = {};
+    int step[VectorDimCount] = {};
+    float tMax[VectorDimCount] = {};
+    float tDelta[VectorDimCount] = {};
+    int maxSteps = 1;
+
+    for (int i = 0; i < VectorDimCount; i++)
+    {
+        const float start = origin[i] + (direction[i] * tEnter);
+        cell[i] = FMath::Clamp(FMath::FloorToInt(start + 0.5f), boundsMin[i], boundsMax[i]);
+        maxSteps += (boundsMax[i] - boundsMin[i]) + 1;
+
+        if (direction[i] > 0.0f)
+        {
+            step[i] = 1;
+            tMax[i] = tEnter + ((cell[i] + 0.5f) - start) / direction[i];
+            tDelta[i] = 1.0f / direction[i];
+        }
+        else if (direction[i] < 0.0f)
+        {
+            step[i] = -1;
+            tMax[i] = tEnter + ((cell[i] - 0.5f) - start) / direction[i];
+            tDelta[i] = -1.0f / direction[i];
+        }
+        else
+        {
+            tMax[i] = FLT_MAX;
+            tDelta[i] = FLT_MAX;
+        }
+    }
+
+    for (int stepCount = 0; stepCount < maxSteps; stepCount++)
+    {
+        m_gazeTraversed.push_back({ cell[0], cell[1], cell[2] });
+
+        int axis = 0;
+        for (int i = 1; i < VectorDimCount; i++)
+        {
+            if (tMax[i] < tMax[axis])
+            {
+                axis = i;
+            }
+        }
+
+        if (tMax[axis] > tExit)
+        {
+            break;
+        }
+
+        cell[axis] += step[axis];
+        tMax[axis] += tDelta[axis];
+    }
+
+    // Gather every cell within reach of the traversed ones, and keep those whose gutter the ray
+    // actually passes through
+    for (int i = 0, traversedCount = static_cast<int>(m_gazeTraversed.size()); i < traversedCount; i++)
+    {
+        const FPipeGridCoordinate traversed = m_gazeTraversed[i];
+        for (int x = -reach; x <= reach; x++)
+        {
+            for (int y = -reach; y <= reach; y++)
+            {
+                for (int z = -reach; z <= reach; z++)
+                {
+                    m_gazeCellLookup.push_back(traversed + FPipeGridCoordinate{ x, y, z });
+                }
+            }
+        }
+    }
+
+    std::sort(m_gazeTraversed.begin(), m_gazeTraversed.end(), CoordinateLess);
+    std::sort(m_gazeCellLookup.begin(), m_gazeCellLookup.end(), CoordinateLess);
+    m_gazeCellLookup.erase(std::unique(m_gazeCellLookup.begin(), m_gazeCellLookup.end()), m_gazeCellLookup.end());
+
+    // Test the candidates' gutters a batch at a time
+    const FVector cornerOffset = FVector(CellSize * gutterHalfSize);
+    FVector minAABBs[GazeBatchSize];
+    FVector maxAABBs[GazeBatchSize];
+    FVector positions[GazeBatchSize];
+    float distances[GazeBatchSize];
+
+    auto itKeep = m_gazeCellLookup.begin();
+    for (size_t first = 0, candidateCount = m_gazeCellLookup.size(); first < candidateCount; first += GazeBatchSize)
+    {
+        const int32 count = static_cast<int32>(FMath::Min<size_t>(GazeBatchSize, candidateCount - first));
+        for (int32 i = 0; i < count; i++)
+        {
+            const FVector location = GridCoordinateToGridLocation(m_gazeCellLookup[first + i]);
+            minAABBs[i] = location - cornerOffset;
+            maxAABBs[i] = location + cornerOffset;
+        }
+
+        const uint32 hits = GazeIntersectsAABBs(minAABBs, maxAABBs, count, positions, distances);
+        for (int32 i = 0; i < count; i++)
+        {
+            if (hits & (1u << i))
+            {
+                // Kept entries only ever move toward the front, so this never overwrites an untested one
+                const FPipeGridCoordinate candidate = m_gazeCellLookup[first + i];
+                const bool direct = std::binary_search(m_gazeTraversed.begin(), m_gazeTraversed.end(), candidate, CoordinateLess);
+                m_gazeCells.push_back({ candidate, distances[i], direct });
+                (*itKeep++) = candidate;
+            }
+        }
+    }
+
+    m_gazeCellLookup.erase(itKeep, m_gazeCellLookup.end());
+
+    std::sort(m_gazeCells.begin(), m_gazeCells.end(), [](const GazeCell& lhs, const GazeCell& rhs) { return lhs.Distance < rhs.Distance; });
+}
+
+bool APPipeGrid::GazeNearCoordinate(const FPipeGridCoordinate& coordinate)
+{
+    if (m_haveGazeCells && CoordinateWithin(coordinate, m_gazeBoundsMin, m_gazeBoundsMax))
+    {
+        return std::binary_search(m_gazeCellLookup.begin(), m_gazeCellLookup.end(), coordinate, CoordinateLess);
+    }
+
+    // Outside of the traversal (a pipe dragged off the grid, say), test the gutter directly
+    const FVector location = GridCoordinateToGridLocation(coordinate);
+    const FVector cornerOffset = FVector(CellSize * FMath::Max(0.0f, FocusGutterRatio / 2.0f));
+    const FVector minAABB = location - cornerOffset;
+    const FVector maxAABB = location + cornerOffset;
+
+    // Through the batched test, so that it agrees exactly with the traversal at the bounds' edges
+    FVector intersection;
+    return (GazeIntersectsAABBs(&minAABB, &maxAABB, 1, &intersection) != 0);
+}
+
+bool APPipeGrid::GazeIntersectsCoordinate(const FPipeGridCoordinate& coordinate, FVector* position)
+{
+    const float halfCell = CellSize / 2.0f;
+    const FVector halfCellVector = FVector(halfCell);
+    const FVector coordinatePosition = GridCoordinateToGridLocation(coordinate);
+
+    return GazeIntersectsAABB(coordinatePosition - halfCellVector, coordinatePosition + halfCellVector, position);
+}
+
+bool APPipeGrid::GazeIntersectsAABB(const FVector& minAABB, const FVector& maxAABB, FVector* position)
+{
+    // Slab test: clip the ray to each axis' pair of planes in turn, and see whether anything is left
+    float tNear = 0.0f;
+    float tFar = FLT_MAX;
+
+    for (int i = 0; tNear <= tFar && i < VectorDimCount; i++)
+    {
+        if (m_gaze.Direction[i] == 0.0f)
+        {
+            if (m_gaze.Origin[i] < minAABB[i] || m_gaze.Origin[i] > maxAABB[i])
+            {
+                tFar = -1.0f;
+            }
+        }
+        else
+        {
+            float t0 = (minAABB[i] - m_gaze.Origin[i]) / m_gaze.Direction[i];
+            float t1 = (maxAABB[i] - m_gaze.Origin[i]) / m_gaze.Direction[i];
+            if (t0 > t1)
+            {
+                std::swap(t0, t1);
+            }
+
+            tNear = FMath::Max(tNear, t0);
+            tFar = FMath::Min(tFar, t1);
+        }
+    }
+
+    const bool intersects = (tNear <= tFar);
+    (*position) = intersects ? m_gaze.Origin + (m_gaze.Direction * tNear) : FVector(0, 0, 0);
+    return intersects;
+}
+
+// Stands in for the inverse of a zero direction component. Finite, so that an origin exactly on a
+// slab's plane gives 0 rather than 0 * infinity (a NaN), but big enough that an origin anywhere else
+// puts the slab impossibly far along the ray
+constexpr float ParallelSlabScale = 1e30f;
+
+uint32 APPipeGrid::GazeIntersectsAABBs(const FVector* minAABBs, const FVector* maxAABBs, int32 count, FVector* positions, float* distances)
+{
+    check(count >= 0 && count <= GazeBatchSize);
+
+    // With no direction at all every axis would be scaled, and a box the origin is outside of could
+    // come out as hit, so leave that to the scalar test
+    if (m_gaze.Direction.IsZero())
+    {
+        uint32 hits = 0;
+        for (int32 i = 0; i < count; i++)
+        {
+            if (GazeIntersectsAABB(minAABBs[i], maxAABBs[i], &positions[i]))
+            {
+                hits |= (1u << i);
+            }
+
+            if (distances)
+            {
+                distances[i] = 0.0f;
+            }
+        }
+
+        return hits;
+    }
+
+    // Lay the boxes out one axis to a register. Lanes past count repeat the first box, and are
+    // masked off at the end
+    float mins[VectorDimCount][GazeBatchSize];
+    float maxs[VectorDimCount][GazeBatchSize];
+
+    for (int32 lane = 0; lane < GazeBatchSize; lane++)
+    {
+        const int32 box = (lane < count) ? lane : 0;
+        for (int i = 0; i < VectorDimCount; i++)
+        {
+            mins[i][lane] = minAABBs[box][i];
+            maxs[i][lane] = maxAABBs[box][i];
+        }
+    }
+
+    // The same slab test as GazeIntersectsAABB, on every box at once
+    VectorRegister tNear = VectorZero();
+    VectorRegister tFar = VectorSetFloat1(FLT_MAX);
+
+    for (int i = 0; i < VectorDimCount; i++)
+    {
+        const float direction = m_gaze.Direction[i];
+        const VectorRegister origin = VectorSetFloat1(m_gaze.Origin[i]);
+        const VectorRegister inverse = VectorSetFloat1((direction != 0.0f) ? (1.0f / direction) : ParallelSlabScale);
+
+        const VectorRegister t0 = VectorMultiply(VectorSubtract(VectorLoad(mins[i]), origin), inverse);
+        const VectorRegister t1 = VectorMultiply(VectorSubtract(VectorLoad(maxs[i]), origin), inverse);
+
+        tNear = VectorMax(tNear, VectorMin(t0, t1));
+        tFar = VectorMin(tFar, VectorMax(t0, t1));
+    }
+
+    const uint32 hits = static_cast<uint32>(VectorMaskBits(VectorCompareGE(tFar, tNear))) & ((1u << count) - 1);
+
+    float tHits[GazeBatchSize];
+    VectorStore(tNear, tHits);
+
+    const float directionLength = m_gaze.Direction.Size();
+    for (int32 i = 0; i < count; i++)
+    {
+        const bool hit = (hits & (1u << i)) != 0;
+        positions[i] = hit ? m_gaze.Origin + (m_gaze.Direction * tHits[i]) : FVector(0, 0, 0);
+
+        if (distances)
+        {
+            distances[i] = hit ? tHits[i] * directionLength : 0.0f;
+        }
+    }
+
+    return hits;
+}
+
+bool APPipeGrid::FindMinDistanceFromGaze(const FVector& position, float* distance)
+{
+    float distanceSq = 0;
+    if (FindMinDistanceFromGazeSq(position, &distanceSq))
+    {
+        (*distance) = sqrt(distanceSq);
+        return true;
+    }
+
+    return false;
+}
+
+bool APPipeGrid::FindMinDistanceFromGazeSq(const FVector& position, float* distance)
+{
+    const FVector originToPosition = (position - m_gaze.Origin);
+    const float originToPositionLengthSq = originToPosition.SizeSquared();
+
+    // Compute distance along gaze to point closest to position
+    float closestDistanceAlongGaze = FVector::DotProduct(originToPosition, m_gaze.Direction);
+
+    // A negative distance means the position is behind us, and therefore not interesting
+    if (closestDistanceAlongGaze > 0)
+    {
+        (*distance) = FVector::DistSquared(m_gaze.Origin + (m_gaze.Direction * closestDistanceAlongGaze), position);
+        return true;
+    }
+
+
+    return false;
+}
+
+void APPipeGrid::MarkPipesForGaze(MarkPipesForGazeMode mode)
+{
+    HOLOPIPES_PROFILE_SCOPE(GridMarkGaze);
+
+    if (mode == MarkPipesForGazeMode::ClearAll)
+    {
+        for (auto& entry : m_pipesGrid)
+        {
+            if (entry.second.pipe && !entry.second.pipe->GetPipeFixed() && !RotateEngaged(entry.first))
+            {
+                entry.second.pipe->SetFocusStage(EFocusStage::None);
+            }
+        }
+
+        m_gazeMarked.clear();
+    }
+    else
+    {
+        // Only the pipes we marked last time and the ones along the ray can change
+        for (const FPipeGridCoordinate& marked : m_gazeMarked)
+        {
+            auto it = m_pipesGrid.find(marked);
+            if (it != m_pipesGrid.end() && it->second.pipe && !it->second.pipe->GetPipeFixed() && !RotateEngaged(it->first))
+            {
+                it->second.pipe->SetFocusStage(EFocusStage::None);
+            }
+        }
+
+        m_gazeMarked.clear();
+
+        for (const GazeCell& gazeCell : m_gazeCells)
+        {
+            if (gazeCell.Direct)
+            {
+                auto it = m_pipesGrid.find(gazeCell.Coordinate);
+                if (it != m_pipesGrid.end() && it->second.pipe && !it->second.pipe->GetPipeFixed() && !RotateEngaged(it->first))
+                {
+                    it->second.pipe->SetFocusStage(EFocusStage::HandAndGaze);
+                    m_gazeMarked.push_back(gazeCell.Coordinate);
+                }
+            }
+        }
+    }
+}
@@ -0,0 +1,462 @@
+
+#include "PPipeGrid_Internal.h"
+
+namespace
+{
+    // The only pipes the player can move, in the order they're packed
+    const EPipeType JournalTypes[] = { EPipeType::Straight, EPipeType::Corner, EPipeType::Junction };
+
+    constexpr int32 JournalAxisBits = 7;
+    constexpr int32 JournalAxisMin = -(1 << (JournalAxisBits - 1));
+    constexpr int32 JournalAxisMax = (1 << (JournalAxisBits - 1)) - 1;
+    constexpr uint64 JournalAxisMask = (1ull << JournalAxisBits) - 1;
+
+    // Op:3 Grouped:1 Scored:1 Type:2 DirectionsBefore:6 DirectionsAfter:6 From:21 To:21
+    constexpr int32 OpShift = 0;
+    constexpr int32 GroupedShift = 3;
+    constexpr int32 ScoredShift = 4;
+    constexpr int32 TypeShift = 5;
+    constexpr int32 DirectionsBeforeShift = 7;
+    constexpr int32 DirectionsAfterShift = 13;
+    constexpr int32 FromShift = 19;
+    constexpr int32 ToShift = FromShift + 3 * JournalAxisBits;
+
+    static_assert(ToShift + 3 * JournalAxisBits <= 64, "Journal entries have to fit in 64 bits");
+
+    int32 JournalTypeIndex(EPipeType type)
+    {
+        for (int32 i = 0; i < static_cast<int32>(ARRAYSIZE(JournalTypes)); i++)
+        {
+            if (JournalTypes[i] == type)
+            {
+                return i;
+            }
+        }
+
+        return -1;
+    }
+
+    bool JournalAxisFits(int32 value)
+    {
+        return value >= JournalAxisMin && value <= JournalAxisMax;
+    }
+
+    uint64 PackJournalCoordinate(const FPipeGridCoordinate& coordinate)
+    {
+        return (static_cast<uint64>(coordinate.X) & JournalAxisMask) |
+               ((static_cast<uint64>(coordinate.Y) & JournalAxisMask) << JournalAxisBits) |
+               ((static_cast<uint64>(coordinate.Z) & JournalAxisMask) << (2 * JournalAxisBits));
+    }
+
+    int32 UnpackJournalAxis(uint64 bits)
+    {
+        int32 value = static_cast<int32>(bits & JournalAxisMask);
+        return (value > JournalAxisMax) ? (value - (1 << JournalAxisBits)) : value;
+    }
+
+    FPipeGridCoordinate UnpackJournalCoordinate(uint64 bits)
+    {
+        return { UnpackJournalAxis(bits), UnpackJournalAxis(bits >> JournalAxisBits), UnpackJournalAxis(bits >> (2 * JournalAxisBits)) };
+    }
+}
+
+bool GridJournalEntry::CanPack() const
+{
+    return (Op == GridJournalOp::ToolboxMove || JournalTypeIndex(Type) >= 0) &&
+           JournalAxisFits(From.X) && JournalAxisFits(From.Y) && JournalAxisFits(From.Z) &&
+           JournalAxisFits(To.X) && JournalAxisFits(To.Y) && JournalAxisFits(To.Z);
+}
+
+uint64 GridJournalEntry::Pack() const
+{
+    const int32 typeIndex = JournalTypeIndex(Type);
+
+    return (static_cast<uint64>(Op) << OpShift) |
+           (static_cast<uint64>(Grouped ? 1 : 0) << GroupedShift) |
+           (static_cast<uint64>(Scored ? 1 : 0) << ScoredShift) |
+           (static_cast<uint64>(typeIndex < 0 ? 0 : typeIndex) << TypeShift) |
+           (static_cast<uint64>(DirectionsBefore) << DirectionsBeforeShift) |
+           (static_cast<uint64>(DirectionsAfter) << DirectionsAfterShift) |
+           (PackJournalCoordinate(From) << FromShift) |
+           (PackJournalCoordinate(To) << ToShift);
+}
+
+GridJournalEntry GridJournalEntry::Unpack(uint64 packed)
+{
+    GridJournalEntry entry;
+    entry.Op = static_cast<GridJournalOp>((packed >> OpShift) & 0x7);
+    entry.Grouped = IsGrouped(packed);
+    entry.Scored = (((packed >> ScoredShift) & 0x1) != 0);
+    entry.Type = (entry.Op == GridJournalOp::ToolboxMove) ? EPipeType::None : JournalTypes[FMath::Min(static_cast<int32>((packed >> TypeShift) & 0x3), static_cast<int32>(ARRAYSIZE(JournalTypes)) - 1)];
+    entry.DirectionsBefore = static_cast<PipeDirections>((packed >> DirectionsBeforeShift) & 0x3F);
+    entry.DirectionsAfter = static_cast<PipeDirections>((packed >> DirectionsAfterShift) & 0x3F);
+    entry.From = UnpackJournalCoordinate(packed >> FromShift);
+    entry.To = UnpackJournalCoordinate(packed >> ToShift);
+    return entry;
+}
+
+bool GridJournalEntry::IsGrouped(uint64 packed)
+{
+    return (((packed >> GroupedShift) & 0x1) != 0);
+}
+
+void GridJournal::Push(const GridJournalEntry& entry)
+{
+    RedoCount = 0;
+
+    if (UndoCount == Capacity)
+    {
+        // Forget the oldest change, along with the rest of its group
+        do
+        {
+            First = (First + 1) % Capacity;
+            UndoCount--;
+        }
+        while (UndoCount > 0 && GridJournalEntry::IsGrouped(At(0)));
+    }
+
+    At(UndoCount) = entry.Pack();
+    UndoCount++;
+}
+
+void GridJournal::Clear()
+{
+    First = 0;
+    UndoCount = 0;
+    RedoCount = 0;
+}
+
+bool APPipeGrid::Undo()
+{
+    if (!CanUndo())
+    {
+        return false;
+    }
+
+    // Undo the last change and everything grouped with it, newest first
+    const int32 last = m_journal.UndoCount - 1;
+    int32 first = last;
+    while (first > 0 && GridJournalEntry::IsGrouped(m_journal.At(first)))
+    {
+        first--;
+    }
+
+    ClearHand(m_hands.Left);
+    ClearHand(m_hands.Right);
+
+    int32 scoredGrasps = 0;
+    const bool applied = ApplyJournalGroup(first, last, true /* undo */, scoredGrasps);
+
+    m_journal.UndoCount = first;
+    m_journal.RedoCount += (last - first + 1);
+
+    FinishApplyingJournal(applied, scoredGrasps, true /* undo */);
+    return applied;
+}
+
+bool APPipeGrid::Redo()
+{
+    if (!CanRedo())
+    {
+        return false;
+    }
+
+    // Redo the next change and everything grouped with it, oldest first
+    const int32 first = m_journal.UndoCount;
+    int32 last = first;
+    while (last + 1 < m_journal.UndoCount + m_journal.RedoCount && GridJournalEntry::IsGrouped(m_journal.At(last + 1)))
+    {
+        last++;
+    }
+
+    ClearHand(m_hands.Left);
+    ClearHand(m_hands.Right);
+
+    int32 scoredGrasps = 0;
+    const bool applied = ApplyJournalGroup(first, last, false /* undo */, scoredGrasps);
+
+    m_journal.UndoCount = last + 1;
+    m_journal.RedoCount -= (last - first + 1);
+
+    FinishApplyingJournal(applied, scoredGrasps, false /* undo */);
+    return applied;
+}
+
+bool APPipeGrid::CanUndo()
+{
+    return m_journal.UndoCount > 0 && CanApplyJournal();
+}
+
+bool APPipeGrid::CanRedo()
+{
+    return m_journal.RedoCount > 0 && CanApplyJournal();
+}
+
+bool APPipeGrid::CanApplyJournal()
+{
+    auto handBusy = [](const GridHand& hand)
+    {
+        return hand.State.InteractionMode == InteractionMode::Translate ||
+               hand.State.InteractionMode == InteractionMode::Rotate ||
+               hand.State.InteractionMode == InteractionMode::ToolboxTranslate;
+    };
+
+    return m_hands.InteractionEnabled &&
+           !IsPopulating() &&
+           !IsToolboxDragging() &&
+           !handBusy(m_hands.Left) &&
+           !handBusy(m_hands.Right);
+}
+
+void APPipeGrid::ClearJournal()
+{
+    m_journal.Clear();
+}
+
+void APPipeGrid::JournalChange(const GridJournalEntry& entry)
+{
+    if (entry.CanPack())
+    {
+        m_journal.Push(entry);
+    }
+    else
+    {
+        // Undoing anything before this would undo it onto a grid that doesn't match
+        ClearJournal();
+    }
+}
+
+void APPipeGrid::JournalDrag(const GridHandState& handState, const FPipeGridCoordinate& dragEnd, bool toolboxDrop)
+{
+    GridJournalEntry entry;
+    entry.Scored = handState.Pipe.GraspScored;
+    entry.Type = handState.Pipe.Actor->GetPipeType();
+
+    if (handState.Drag.FromToolbox)
+    {
+        if (toolboxDrop)
+        {
+            // Back where it started
+            return;
+        }
+
+        entry.Op = GridJournalOp::Take;
+        entry.To = dragEnd;
+        entry.DirectionsAfter = handState.Pipe.Actor->GetPipeDirections();
+    }
+    else if (toolboxDrop)
+    {
+        entry.Op = GridJournalOp::Return;
+        entry.From = handState.Pipe.StartCoordinate;
+        entry.DirectionsBefore = handState.Pipe.StartDirections;
+    }
+    else
+    {
+        entry.Op = GridJournalOp::Move;
+        entry.From = handState.Pipe.StartCoordinate;
+        entry.To = dragEnd;
+        entry.DirectionsBefore = handState.Pipe.StartDirections;
+        entry.DirectionsAfter = handState.Pipe.Actor->GetPipeDirections();
+
+        if (entry.From == entry.To && entry.DirectionsBefore == entry.DirectionsAfter)
+        {
+            return;
+        }
+    }
+
+    JournalChange(entry);
+}
+
+void APPipeGrid::JournalRotate(const GridHandState& handState)
+{
+    GridJournalEntry entry;
+    entry.Op = GridJournalOp::Move;
+    entry.Scored = handState.Pipe.GraspScored;
+    entry.Type = handState.Pipe.Actor->GetPipeType();
+    entry.From = handState.Pipe.StartCoordinate;
+    entry.To = handState.Pipe.StartCoordinate;
+    entry.DirectionsBefore = handState.Pipe.StartDirections;
+    entry.DirectionsAfter = handState.Pipe.Actor->GetPipeDirections();
+
+    if (entry.DirectionsBefore != entry.DirectionsAfter)
+    {
+        JournalChange(entry);
+    }
+}
+
+void APPipeGrid::JournalToolboxMove(const FPipeGridCoordinate& from, const FPipeGridCoordinate& to)
+{
+    if (from != to)
+    {
+        GridJournalEntry entry;
+        entry.Op = GridJournalOp::ToolboxMove;
+        entry.From = from;
+        entry.To = to;
+
+        JournalChange(entry);
+    }
+}
+
+bool APPipeGrid::ApplyJournalGroup(int32 first, int32 last, bool undo, int32& scoredGrasps)
+{
+    // Undo goes newest first, and redo oldest first
+    const int32 step = undo ? -1 : 1;
+    const int32 begin = undo ? last : first;
+    const int32 end = undo ? (first - 1) : (last + 1);
+
+    for (int32 index = begin; index != end; index += step)
+    {
+        const GridJournalEntry entry = GridJournalEntry::Unpack(m_journal.At(index));
+
+        if (!ApplyJournalEntry(entry, undo))
+        {
+            // Take back the part of the group that was applied, in reverse, so the grid is left the
+            // way the player made it rather than half way between two of their changes
+            for (int32 applied = index - step; applied != begin - step; applied -= step)
+            {
+                if (!ApplyJournalEntry(GridJournalEntry::Unpack(m_journal.At(applied)), !undo))
+                {
+                    UE_LOG(HoloPipesLog, Error, L"APPipeGrid::%s - Unable to take back a partly applied change", (undo ? L"Undo" : L"Redo"));
+                }
+            }
+
+            return false;
+        }
+
+        scoredGrasps += entry.Scored ? 1 : 0;
+    }
+
+    return true;
+}
+
+bool APPipeGrid::ApplyJournalEntry(const GridJournalEntry& entry, bool undo)
+{
+    bool applied = false;
+
+    switch (entry.Op)
+    {
+        case GridJournalOp::Move:
+            applied = undo ? JournalMovePipe(entry.To, entry.From, entry.DirectionsBefore) : JournalMovePipe(entry.From, entry.To, entry.DirectionsAfter);
+            break;
+
+        case GridJournalOp::Take:
+            applied = undo ? JournalReturnPipe(entry.Type, entry.To) : JournalTakePipe(entry.Type, entry.To, entry.DirectionsAfter);
+            break;
+
+        case GridJournalOp::Return:
+            applied = undo ? JournalTakePipe(entry.Type, entry.From, entry.DirectionsBefore) : JournalReturnPipe(entry.Type, entry.From);
+            break;
+
+        case GridJournalOp::ToolboxMove:
+            applied = TrySetToolboxCoordinate(undo ? entry.From : entry.To);
+            if (applied)
+            {
+                OnToolboxMoved.Broadcast();
+            }
+            break;
+    }
+
+    return applied;
+}
+
+bool APPipeGrid::JournalMovePipe(const FPipeGridCoordinate& from, const FPipeGridCoordinate& to, PipeDirections directions)
+{
+    auto it = m_pipesGrid.find(from);
+    if (it == m_pipesGrid.end() || !it->second.pipe || it->second.pipe->GetPipeFixed() || it->second.pipe->GetInToolbox())
+    {
+        return false;
+    }
+
+    if (from != to && m_pipesGrid.find(to) != m_pipesGrid.end())
+    {
+        return false;
+    }
+
+    APPipe* pipe = it->second.pipe;
+
+    MarkConnectivityDirty(from);
+    EraseGridPipe(it);
+
+    MarkConnectivityDirty(to);
+    pipe->SetPipeDirections(directions);
+
+    GridPipe movedPipe;
+    movedPipe.pipe = pipe;
+    movedPipe.currentLocation = to;
+    movedPipe.currentPipeClass = DefaultPipeClass;
+    PutGridPipe(movedPipe);
+
+    FRotator rotation;
+    GetPipeRotation(pipe->GetPipeType(), directions, rotation);
+    pipe->SetActorRelativeTransform(FTransform(rotation, GridCoordinateToGridLocation(to)));
+
+    UpdatePipeConnections(from);
+    UpdatePipeConnections(to);
+
+    return true;
+}
+
+bool APPipeGrid::JournalTakePipe(EPipeType type, const FPipeGridCoordinate& to, PipeDirections directions)
+{
+    if (!Toolbox || Toolbox->CountRemaining(type) == 0 || m_pipesGrid.find(to) != m_pipesGrid.end())
+    {
+        return false;
+    }
+
+    PipeSegmentGenerated segment = {};
+    segment.Type = type;
+    segment.PipeClass = DefaultPipeClass;
+    segment.Connections = directions;
+    segment.Location = to;
+
+    AddPipe(segment, AddPipeOptions::FromToolbox);
+
+    auto it = m_pipesGrid.find(to);
+    return it != m_pipesGrid.end() && it->second.pipe;
+}
+
+bool APPipeGrid::JournalReturnPipe(EPipeType type, const FPipeGridCoordinate& from)
+{
+    auto it = m_pipesGrid.find(from);
+    if (!Toolbox ||
+        it == m_pipesGrid.end() ||
+        !it->second.pipe ||
+        it->second.pipe->GetPipeFixed() ||
+        it->second.pipe->GetInToolbox() ||
+        it->second.pipe->GetPipeType() != type)
+    {
+        return false;
+    }
+
+    MarkConnectivityDirty(from);
+    ReleasePipe(it->second.pipe);
+    EraseGridPipe(it);
+    UpdatePipeConnections(from);
+
+    Toolbox->AddPipe(type);
+    SpawnInToolbox(type);
+
+    return true;
+}
+
+void APPipeGrid::FinishApplyingJournal(bool applied, int32 scoredGrasps, bool undo)
+{
+    if (applied)
+    {
+        ScoreUndo(scoredGrasps, undo);
+    }
+    else
+    {
+        // Something changed the grid without journaling it, so the rest can't be trusted either. The
+        // grid itself is as it was before this undo or redo
+        UE_LOG(HoloPipesLog, Warning, L"APPipeGrid::%s - The grid doesn't match its journal, clearing it", (undo ? L"Undo" : L"Redo"));
+        ClearJournal();
+    }
+
+    EnsureToolboxPipes();
+
+    if (!CheckForSolution())
+    {
+        OnGridUpdated.Broadcast();
+    }
+}
@@ -0,0 +1,77 @@
+#pragma once
+
+#include "PPipe.h"
+#include "PPipeGrid_Journal.generated.h"
+
+// How undo and redo count toward the level score (see APPipeGrid::UndoScoring)
+UENUM(BlueprintType)
+enum class EUndoScoring : uint8
+{
+    // Undo and redo don't change the score
+    Free,
+
+    // Undoing a change takes back what its grasp added to the score, and redoing it adds it again
+    Refund,
+
+    // Each undo and redo adds UndoScorePenalty to the score
+    Penalty
+};
+
+enum class GridJournalOp : uint8
+{
+    // A placed pipe was dragged from From to To, or rotated in place when they're the same
+    Move,
+
+    // A pipe was dragged out of the toolbox to To
+    Take,
+
+    // The placed pipe at From went back into the toolbox
+    Return,
+
+    // The toolbox was dragged from From to To
+    ToolboxMove
+};
+
+// One change to the grid, as the player made it. Undone by making the opposite change
+struct GridJournalEntry
+{
+    GridJournalOp Op = GridJournalOp::Move;
+
+    // Undone and redone together with the entry before it
+    bool Grouped = false;
+
+    // The grasp that made the change added to the level score
+    bool Scored = false;
+
+    EPipeType Type = EPipeType::None;
+    PipeDirections DirectionsBefore = PipeDirections::None;
+    PipeDirections DirectionsAfter = PipeDirections::None;
+
+    FPipeGridCoordinate From = FPipeGridCoordinate::Zero;
+    FPipeGridCoordinate To = FPipeGridCoordinate::Zero;
+
+    // Entries are packed into 64 bits, which leaves 7 bits (-64 to 63) for each axis of a coordinate
+    // and only room for the toolbox's pipe types. Changes that don't fit can't be journaled
+    bool CanPack() const;
+    uint64 Pack() const;
+    static GridJournalEntry Unpack(uint64 packed);
+    static bool IsGrouped(uint64 packed);
+};
+
+// The last Capacity changes to the grid, oldest first, as a ring of packed entries. The first UndoCount
+// can be undone, and the RedoCount after them have been undone and can be redone. Anything new that's
+// journaled drops what could be redone
+struct GridJournal
+{
+    static constexpr int32 Capacity = 512;
+
+    uint64 Entries[Capacity] = {};
+    int32 First = 0;
+    int32 UndoCount = 0;
+    int32 RedoCount = 0;
+
+    uint64& At(int32 index) { return Entries[(First + index) % Capacity]; }
+
+    void Push(const GridJournalEntry& entry);
+    void Clear();
+};
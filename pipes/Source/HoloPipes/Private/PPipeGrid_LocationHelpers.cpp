@@ -1,50 +1,79 @@
-
-#include "PPipeGrid_Internal.h"
-
-
-
-FVector APPipeGrid::WorldLocationToTransformLocation(const FVector& worldLocation, const FTransform& toWorldTransform)
-{
-    return toWorldTransform.Inverse().TransformPosition(worldLocation);
-}
-
-FVector APPipeGrid::TransformLocationToWorldLocation(const FVector& transformLocation, const FTransform& toWorldTransform)
-{
-    return toWorldTransform.TransformPosition(transformLocation);
-}
-
-FVector APPipeGrid::WorldLocationToGridLocation(const FVector& worldLocation)
-{
-    return WorldLocationToTransformLocation(worldLocation, GetActorTransform());
-}
-
-FTransform APPipeGrid::WorldTransformToGridTransform(const FTransform& worldTransform)
-{
-    const FTransform gridToWorld = GetActorTransform();
-    const FTransform worldToGrid = gridToWorld.Inverse();
-    return worldTransform * worldToGrid;
-}
-
-FVector APPipeGrid::GridLocationToWorldLocation(const FVector& gridLocation)
-{
-    return TransformLocationToWorldLocation(gridLocation, GetActorTransform());
-}
-
-FPipeGridCoordinate APPipeGrid::GridLocationToGridCoordinate(const FVector& gridLocation)
-{
-    return
-    {
-        (int)round(gridLocation.X / CellSize),
-        (int)round(gridLocation.Y / CellSize),
-        (int)round(gridLocation.Z / CellSize)
-    };
-}
-
-FVector APPipeGrid::GridCoordinateToGridLocation(const FPipeGridCoordinate& gridCoordinate)
-{
-    return {
-        CellSize * gridCoordinate.X,
-        CellSize * gridCoordinate.Y,
-        CellSize * gridCoordinate.Z
-    };
+
+#include "PPipeGrid_Internal.h"
+
+
+
+FVector APPipeGrid::WorldLocationToTransformLocation(const FVector& worldLocation, const FTransform& toWorldTransform)
+{
+    HOLOPIPES_PROFILE_COUNT(TransformsInverted, 1);
+    return toWorldTransform.Inverse().TransformPosition(worldLocation);
+}
+
+FVector APPipeGrid::TransformLocationToWorldLocation(const FVector& transformLocation, const FTransform& toWorldTransform)
+{
+    return toWorldTransform.TransformPosition(transformLocation);
+}
+
+FVector APPipeGrid::WorldLocationToGridLocation(const FVector& worldLocation)
+{
+    return GetWorldToGrid().TransformPosition(worldLocation);
+}
+
+FTransform APPipeGrid::WorldTransformToGridTransform(const FTransform& worldTransform)
+{
+    return worldTransform * GetWorldToGrid();
+}
+
+FVector APPipeGrid::GridLocationToWorldLocation(const FVector& gridLocation)
+{
+    return TransformLocationToWorldLocation(gridLocation, GetGridToWorld());
+}
+
+const FTransform& APPipeGrid::GetGridToWorld()
+{
+    if (m_gridTransformDirty)
+    {
+        HOLOPIPES_PROFILE_COUNT(TransformsInverted, 1);
+
+        m_gridToWorld = GetActorTransform();
+        m_worldToGrid = m_gridToWorld.Inverse();
+        m_gridTransformDirty = false;
+    }
+
+    return m_gridToWorld;
+}
+
+const FTransform& APPipeGrid::GetWorldToGrid()
+{
+    GetGridToWorld();
+    return m_worldToGrid;
+}
+
+void APPipeGrid::MarkGridTransformDirty()
+{
+    m_gridTransformDirty = true;
+}
+
+void APPipeGrid::HandleRootTransformUpdated(USceneComponent* updatedComponent, EUpdateTransformFlags updateTransformFlags, ETeleportType teleport)
+{
+    MarkGridTransformDirty();
+}
+
+FPipeGridCoordinate APPipeGrid::GridLocationToGridCoordinate(const FVector& gridLocation)
+{
+    return
+    {
+        (int)round(gridLocation.X / CellSize),
+        (int)round(gridLocation.Y / CellSize),
+        (int)round(gridLocation.Z / CellSize)
+    };
+}
+
+FVector APPipeGrid::GridCoordinateToGridLocation(const FPipeGridCoordinate& gridCoordinate)
+{
+    return {
+        CellSize * gridCoordinate.X,
+        CellSize * gridCoordinate.Y,
+        CellSize * gridCoordinate.Z
+    };
 }
\ No newline at end of file
@@ -0,0 +1,105 @@
+
+#include "PPipeGrid_Internal.h"
+
+namespace
+{
+    // Each pipe type is a single bit, so its pool is the index of that bit
+    int PipePoolIndexOf(EPipeType type)
+    {
+        const uint32 bits = static_cast<uint32>(type);
+        if (bits == 0 || (bits & (bits - 1)) != 0)
+        {
+            return -1;
+        }
+
+        return static_cast<int>(FMath::FloorLog2(bits));
+    }
+}
+
+APPipe* APPipeGrid::AcquirePipe(EPipeType type)
+{
+    const int poolIndex = PipePoolIndexOf(type);
+    if (poolIndex >= 0 && poolIndex < PipePoolCount)
+    {
+        std::vector<TWeakObjectPtr<APPipe>>& pool = m_pipePool[poolIndex];
+        while (!pool.empty())
+        {
+            APPipe* pipe = pool.back().Get();
+            pool.pop_back();
+
+            if (pipe)
+            {
+                HOLOPIPES_PROFILE_COUNT(PipesReused, 1);
+                return pipe;
+            }
+        }
+    }
+
+    if (!PipeClass)
+    {
+        return nullptr;
+    }
+
+    // Owned by the grid, which sends its Blueprint events
+    FActorSpawnParameters spawnParameters;
+    spawnParameters.Owner = this;
+
+    HOLOPIPES_PROFILE_COUNT(PipesSpawned, 1);
+    return GetWorld()->SpawnActor<APPipe>(PipeClass, spawnParameters);
+}
+
+void APPipeGrid::ReleasePipe(APPipe* pipe)
+{
+    if (pipe == nullptr)
+    {
+        return;
+    }
+
+    // A pipe that never got a valid type, or isn't of the class the grid spawns, can't be handed out again
+    const int poolIndex = PipePoolIndexOf(pipe->GetPipeType());
+    if (poolIndex < 0 || poolIndex >= PipePoolCount || pipe->GetClass() != PipeClass.Get())
+    {
+        pipe->Destroy();
+        return;
+    }
+
+    // Releasing a pipe that's already pooled must not hand it out twice
+    if (pipe->Deactivate())
+    {
+        HOLOPIPES_PROFILE_COUNT(PipesReleased, 1);
+        m_pipePool[poolIndex].push_back(pipe);
+    }
+}
+
+void APPipeGrid::ReleaseProxy(GridHandProxy& proxy)
+{
+    ReleasePipe(proxy.Actor);
+    proxy.Actor = nullptr;
+}
+
+void APPipeGrid::DestroyPipePool()
+{
+    // Pipes waiting to be released would only end up here
+    for (const TWeakObjectPtr<APPipe>& pipe : m_retiringPipes)
+    {
+        if (pipe.IsValid())
+        {
+            pipe->Destroy();
+        }
+    }
+
+    m_retiringPipes.clear();
+
+    for (std::vector<TWeakObjectPtr<APPipe>>& pool : m_pipePool)
+    {
+        for (const TWeakObjectPtr<APPipe>& pipe : pool)
+        {
+            if (pipe.IsValid())
+            {
+                pipe->Destroy();
+            }
+        }
+
+        pool.clear();
+    }
+}
@@ -0,0 +1,155 @@
+
+#include "PPipeGrid_Internal.h"
+#include "HAL/PlatformTime.h"
+#include <algorithm>
+
+namespace
+{
+    // How far the gaze has to move, in cells, or turn, as the cosine of the angle, before a batch
+    // waiting to populate is sorted again. Anything less barely changes the order
+    constexpr float PopulationResortCells = 0.5f;
+    constexpr float PopulationResortCosAngle = 0.996f; // About 5 degrees
+}
+
+void APPipeGrid::QueuePipes(const std::vector<PipeSegmentGenerated>& pipes, AddPipeOptions options)
+{
+    if (pipes.empty())
+    {
+        return;
+    }
+
+    if (!IsPopulating())
+    {
+        m_enableInteractionWhenPopulated = m_hands.InteractionEnabled;
+        SetInteractionEnabled(false);
+    }
+
+    m_populationBatches.push_back({ pipes, options });
+}
+
+bool APPipeGrid::IsPopulating() const
+{
+    return !m_populationBatches.empty();
+}
+
+void APPipeGrid::FinishPopulation()
+{
+    while (PopulateNext())
+    {
+    }
+}
+
+void APPipeGrid::UpdatePopulation()
+{
+    if (m_retiringPipes.empty() && m_populationBatches.empty())
+    {
+        return;
+    }
+
+    HOLOPIPES_PROFILE_SCOPE(GridPopulate);
+
+    // Sorting comes out of the budget too
+    const double deadline = FPlatformTime::Seconds() + (FMath::Max(0.0f, PopulateBudgetMs) / 1000.0);
+
+    // Always get at least one thing done, however small the budget. The batch being populated is
+    // sorted again whenever the gaze has moved enough to matter
+    do
+    {
+        if (!m_populationBatches.empty())
+        {
+            SortPopulationBatchByGaze(m_populationBatches.front());
+        }
+    }
+    while (PopulateNext() && FPlatformTime::Seconds() < deadline);
+}
+
+bool APPipeGrid::PopulateNext()
+{
+    // Clear out the old level before bringing in the new one, so its pipes can be reused
+    while (!m_retiringPipes.empty())
+    {
+        APPipe* pipe = m_retiringPipes.back().Get();
+        m_retiringPipes.pop_back();
+
+        if (pipe)
+        {
+            HOLOPIPES_PROFILE_COUNT(PipesRetired, 1);
+            ReleasePipe(pipe);
+            return true;
+        }
+    }
+
+    if (m_populationBatches.empty())
+    {
+        return false;
+    }
+
+    // Batches are sorted nearest the gaze last
+    PopulationBatch& batch = m_populationBatches.front();
+    if (!batch.Pipes.empty())
+    {
+        const PipeSegmentGenerated pipe = batch.Pipes.back();
+        batch.Pipes.pop_back();
+
+        HOLOPIPES_PROFILE_COUNT(PipesPopulated, 1);
+        AddPipe(pipe, batch.Options);
+    }
+
+    if (batch.Pipes.empty())
+    {
+        m_populationBatches.erase(m_populationBatches.begin());
+
+        if (m_populationBatches.empty() && m_enableInteractionWhenPopulated)
+        {
+            m_enableInteractionWhenPopulated = false;
+            SetInteractionEnabled(true);
+        }
+    }
+
+    return true;
+}
+
+void APPipeGrid::SortPopulationBatchByGaze(PopulationBatch& batch)
+{
+    if (batch.Sorted)
+    {
+        const float resortDistance = PopulationResortCells * CellSize;
+
+        if (FVector::DistSquared(batch.SortedForGaze.Origin, m_gaze.Origin) <= (resortDistance * resortDistance) &&
+            FVector::DotProduct(batch.SortedForGaze.Direction, m_gaze.Direction) >= PopulationResortCosAngle)
+        {
+            return;
+        }
+    }
+
+    batch.SortedForGaze = m_gaze;
+    batch.Sorted = true;
+
+    std::vector<std::pair<float, int>> ranked;
+    ranked.reserve(batch.Pipes.size());
+
+    for (int i = 0, count = static_cast<int>(batch.Pipes.size()); i < count; i++)
+    {
+        // Pipes behind the gaze (or all of them, before there is one) go after the rest
+        float distanceSq = 0.0f;
+        if (!FindMinDistanceFromGazeSq(GridCoordinateToGridLocation(batch.Pipes[i].Location), &distanceSq))
+        {
+            distanceSq = FLT_MAX;
+        }
+
+        ranked.push_back({ distanceSq, i });
+    }
+
+    // Farthest first, since pipes are taken from the back
+    std::stable_sort(ranked.begin(), ranked.end(), [](const std::pair<float, int>& lhs, const std::pair<float, int>& rhs) { return lhs.first > rhs.first; });
+
+    std::vector<PipeSegmentGenerated> sorted;
+    sorted.reserve(batch.Pipes.size());
+
+    for (const std::pair<float, int>& entry : ranked)
+    {
+        sorted.push_back(batch.Pipes[entry.second]);
+    }
+
+    batch.Pipes = std::move(sorted);
+}
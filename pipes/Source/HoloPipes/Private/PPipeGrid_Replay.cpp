@@ -0,0 +1,633 @@
+
+#include "PPipeGrid_Internal.h"
+#include "Serialization/MemoryWriter.h"
+#include "Serialization/MemoryReader.h"
+#include "Misc/FileHelper.h"
+#include <algorithm>
+
+namespace
+{
+    constexpr uint32 InteractionLogMagic = 0x4C495048; // "HPIL"
+    constexpr uint32 InteractionLogVersion = 1;
+
+    void SerializeCoordinate(FArchive& ar, FPipeGridCoordinate& coordinate)
+    {
+        ar << coordinate.X << coordinate.Y << coordinate.Z;
+    }
+
+    // Hands are almost never scaled, so the scale is left out unless they are
+    void SerializeHandTransform(FArchive& ar, FTransform& transform)
+    {
+        FVector location = transform.GetLocation();
+        FQuat rotation = transform.GetRotation();
+        FVector scale = transform.GetScale3D();
+        uint8 scaled = scale.Equals(FVector::OneVector, 0.0f) ? 0 : 1;
+
+        ar << scaled << location << rotation;
+        if (scaled)
+        {
+            ar << scale;
+        }
+
+        if (ar.IsLoading())
+        {
+            transform = FTransform(rotation, location, scaled ? scale : FVector::OneVector);
+        }
+    }
+
+    void SerializeFingerGesture(FArchive& ar, FFingerGestureUpdate& gesture)
+    {
+        uint8 progress = static_cast<uint8>(gesture.Progress);
+        ar << progress;
+        gesture.Progress = static_cast<EGestureProgress>(progress);
+
+        SerializeHandTransform(ar, gesture.Target);
+        SerializeHandTransform(ar, gesture.Attach);
+    }
+
+    void SerializeSegment(FArchive& ar, PipeSegmentGenerated& segment)
+    {
+        uint8 type = static_cast<uint8>(segment.Type);
+        int32 pipeClass = segment.PipeClass;
+        int32 connections = static_cast<int32>(segment.Connections);
+
+        ar << type << pipeClass << connections;
+        SerializeCoordinate(ar, segment.Location);
+
+        segment.Type = static_cast<EPipeType>(type);
+        segment.PipeClass = pipeClass;
+        segment.Connections = static_cast<PipeDirections>(connections);
+    }
+
+    void SerializeHeader(FArchive& ar, InteractionLogHeader& header)
+    {
+        // Only the options that change the level's layout
+        FGenerateOptions& options = header.Options;
+        ar << options.Level << options.PlaySpaceSize << options.MaxNumPipes << options.MaxJunctions << options.MaxFixed << options.MaxBlocks;
+        ar << options.StraightCost << options.CornerCost << options.BeamWidth << options.MemoryBudgetKB;
+        ar << options.MutationSeed << options.MutationFraction;
+
+        ar << header.BuildSolution;
+        ar << header.Fingerprint.Low << header.Fingerprint.High;
+
+        int32 placedCount = static_cast<int32>(header.Placed.size());
+        ar << placedCount;
+
+        if (ar.IsLoading())
+        {
+            if (placedCount < 0 || placedCount > ar.TotalSize())
+            {
+                ar.SetError();
+                return;
+            }
+
+            header.Placed.resize(placedCount);
+        }
+
+        for (PipeSegmentGenerated& segment : header.Placed)
+        {
+            SerializeSegment(ar, segment);
+        }
+
+        ar << header.HaveToolboxCoordinate;
+        SerializeCoordinate(ar, header.ToolboxCoordinate);
+
+        ar << header.GridTransform;
+    }
+
+    void SerializeRecord(FArchive& ar, InteractionRecord& record)
+    {
+        uint8 type = static_cast<uint8>(record.Type);
+        ar << type << record.Time;
+        record.Type = static_cast<InteractionRecordType>(type);
+
+        switch (record.Type)
+        {
+            case InteractionRecordType::Gaze:
+                ar << record.Gaze.Origin << record.Gaze.Direction;
+                break;
+
+            case InteractionRecordType::Gesture:
+                SerializeFingerGesture(ar, record.Gesture.Left);
+                SerializeFingerGesture(ar, record.Gesture.Right);
+                break;
+
+            case InteractionRecordType::GridTransform:
+                ar << record.GridTransform;
+                break;
+
+            case InteractionRecordType::Enabled:
+            {
+                uint8 enabled = static_cast<uint8>(record.Enabled);
+                ar << enabled;
+                record.Enabled = static_cast<InteractionEnabledFlags>(enabled);
+                break;
+            }
+
+            default:
+                ar.SetError();
+                break;
+        }
+    }
+
+#if !UE_BUILD_SHIPPING
+    double Percentile(std::vector<double>& values, double fraction)
+    {
+        if (values.empty())
+        {
+            return 0.0;
+        }
+
+        const size_t index = std::min(values.size() - 1, static_cast<size_t>(fraction * values.size()));
+        std::nth_element(values.begin(), values.begin() + index, values.end());
+        return values[index];
+    }
+#endif
+}
+
+bool InteractionLog::Save(const FString& path) const
+{
+    TArray<uint8> bytes;
+    FMemoryWriter ar(bytes);
+
+    uint32 magic = InteractionLogMagic;
+    uint32 version = InteractionLogVersion;
+    ar << magic << version;
+
+    InteractionLogHeader header = Header;
+    SerializeHeader(ar, header);
+
+    int32 recordCount = static_cast<int32>(Records.size());
+    ar << recordCount;
+
+    for (const InteractionRecord& record : Records)
+    {
+        InteractionRecord copy = record;
+        SerializeRecord(ar, copy);
+    }
+
+    return FFileHelper::SaveArrayToFile(bytes, *path);
+}
+
+bool InteractionLog::Load(const FString& path)
+{
+    TArray<uint8> bytes;
+    if (!FFileHelper::LoadFileToArray(bytes, *path))
+    {
+        return false;
+    }
+
+    FMemoryReader ar(bytes);
+
+    uint32 magic = 0;
+    uint32 version = 0;
+    ar << magic << version;
+
+    if (ar.IsError() || magic != InteractionLogMagic || version != InteractionLogVersion)
+    {
+        return false;
+    }
+
+    Header = {};
+    SerializeHeader(ar, Header);
+
+    int32 recordCount = 0;
+    ar << recordCount;
+
+    if (ar.IsError() || recordCount < 0 || recordCount > bytes.Num())
+    {
+        return false;
+    }
+
+    Records.clear();
+    Records.resize(recordCount);
+
+    for (InteractionRecord& record : Records)
+    {
+        SerializeRecord(ar, record);
+        if (ar.IsError())
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+float APPipeGrid::GetInteractionTime()
+{
+#if !UE_BUILD_SHIPPING
+    if (m_replay.Replaying)
+    {
+        return m_replay.Time;
+    }
+#endif
+
+    return GetWorld()->GetTimeSeconds();
+}
+
+bool APPipeGrid::StartInputRecording(const FGenerateOptions& options, bool buildSolution, const LevelFingerprint& fingerprint)
+{
+#if UE_BUILD_SHIPPING
+    return false;
+#else
+    if (m_replay.Recording || m_replay.Replaying || IsPopulating())
+    {
+        UE_LOG(HoloPipesLog, Error, L"APPipeGrid::StartInputRecording - Can't record while recording, replaying or populating the level");
+        return false;
+    }
+
+    InteractionLogHeader& header = m_replay.Log.Header;
+    header = {};
+    header.Options = options;
+    header.BuildSolution = buildSolution;
+    header.Fingerprint = fingerprint;
+    header.HaveToolboxCoordinate = GetToolboxCoordinate(&header.ToolboxCoordinate);
+    header.GridTransform = GetActorTransform();
+    GetCurrentPlaced(header.Placed);
+
+    m_replay.Log.Records.clear();
+    m_replay.Recording = true;
+    m_replay.RecordingStart = GetWorld()->GetTimeSeconds();
+    m_replay.RecordedTransform = header.GridTransform;
+
+    // The replay starts from a freshly built level, so it needs to know what's switched on
+    InteractionRecord record;
+    record.Type = InteractionRecordType::Enabled;
+    record.Enabled = GetInteractionEnabledFlags();
+
+    m_replay.RecordedEnabled = record.Enabled;
+    m_replay.Log.Records.push_back(record);
+
+    return true;
+#endif
+}
+
+bool APPipeGrid::StopInputRecording(const FString& path)
+{
+#if UE_BUILD_SHIPPING
+    return false;
+#else
+    if (!m_replay.Recording && m_replay.Log.Records.empty())
+    {
+        UE_LOG(HoloPipesLog, Error, L"APPipeGrid::StopInputRecording - Not recording");
+        return false;
+    }
+
+    m_replay.Recording = false;
+
+    const bool saved = m_replay.Log.Save(path);
+    if (saved)
+    {
+        UE_LOG(HoloPipesLog, Display, L"APPipeGrid::StopInputRecording - Wrote %d records to %s", static_cast<int32>(m_replay.Log.Records.size()), *path);
+    }
+    else
+    {
+        UE_LOG(HoloPipesLog, Error, L"APPipeGrid::StopInputRecording - Unable to write %s", *path);
+    }
+
+    m_replay.Log = {};
+    return saved;
+#endif
+}
+
+bool APPipeGrid::IsRecordingInput() const
+{
+#if UE_BUILD_SHIPPING
+    return false;
+#else
+    return m_replay.Recording;
+#endif
+}
+
+#if !UE_BUILD_SHIPPING
+
+InteractionEnabledFlags APPipeGrid::GetInteractionEnabledFlags()
+{
+    InteractionEnabledFlags flags = InteractionEnabledFlags::None;
+
+    if (m_hands.InteractionEnabled || m_enableInteractionWhenPopulated)
+    {
+        flags |= InteractionEnabledFlags::Interaction;
+    }
+
+    if (m_dragEnabled)
+    {
+        flags |= InteractionEnabledFlags::Drag;
+    }
+
+    if (m_rotateEnabled)
+    {
+        flags |= InteractionEnabledFlags::Rotate;
+    }
+
+    if (m_toolboxEnabled)
+    {
+        flags |= InteractionEnabledFlags::Toolbox;
+    }
+
+    if (m_placeWorldState.Mode != PlaceWorldMode::None)
+    {
+        flags |= InteractionEnabledFlags::PlaceWorld;
+    }
+
+    return flags;
+}
+
+void APPipeGrid::RecordInput(InteractionRecord& record)
+{
+    if (!m_replay.Recording)
+    {
+        return;
+    }
+
+    record.Time = GetWorld()->GetTimeSeconds() - m_replay.RecordingStart;
+
+    // The grid's transform and switches rarely change, so they're only written when they do
+    const FTransform transform = GetActorTransform();
+    if (!transform.Equals(m_replay.RecordedTransform, 0.0f))
+    {
+        InteractionRecord moved;
+        moved.Type = InteractionRecordType::GridTransform;
+        moved.Time = record.Time;
+        moved.GridTransform = transform;
+
+        m_replay.RecordedTransform = transform;
+        m_replay.Log.Records.push_back(moved);
+    }
+
+    const InteractionEnabledFlags enabled = GetInteractionEnabledFlags();
+    if (enabled != m_replay.RecordedEnabled)
+    {
+        InteractionRecord switched;
+        switched.Type = InteractionRecordType::Enabled;
+        switched.Time = record.Time;
+        switched.Enabled = enabled;
+
+        m_replay.RecordedEnabled = enabled;
+        m_replay.Log.Records.push_back(switched);
+    }
+
+    m_replay.Log.Records.push_back(record);
+}
+
+void APPipeGrid::RecordGaze(const FGazeUpdate& update)
+{
+    if (m_replay.Recording)
+    {
+        InteractionRecord record;
+        record.Type = InteractionRecordType::Gaze;
+        record.Gaze = update;
+
+        RecordInput(record);
+    }
+}
+
+void APPipeGrid::RecordGesture(const FGestureUpdate& update)
+{
+    if (m_replay.Recording)
+    {
+        InteractionRecord record;
+        record.Type = InteractionRecordType::Gesture;
+        record.Gesture = update;
+
+        RecordInput(record);
+    }
+}
+
+void APPipeGrid::EndInputRecording()
+{
+    if (m_replay.Recording)
+    {
+        // Anything after this happened on another level
+        UE_LOG(HoloPipesLog, Warning, L"APPipeGrid - The grid was cleared, so input recording has stopped");
+        m_replay.Recording = false;
+    }
+}
+
+bool APPipeGrid::RebuildRecordedLevel(const InteractionLogHeader& header)
+{
+    FGenerateOptions options = header.Options;
+    options.SolverBudgetMs = 0.0f;
+    options.StreamPipes = false;
+
+    LevelGenerator generator;
+    if (!generator.GenerateLevelSync(options) || generator.GetStatus() != GeneratorStatus::Complete)
+    {
+        UE_LOG(HoloPipesLog, Error, L"APPipeGrid::ReplayInput - Unable to generate level %d", options.Level);
+        return false;
+    }
+
+    // Input recorded on another level would do something else entirely
+    if (generator.GetFingerprint() != header.Fingerprint)
+    {
+        UE_LOG(HoloPipesLog, Error, L"APPipeGrid::ReplayInput - Level %d generated as %s, but was recorded on %s",
+            options.Level, *generator.GetFingerprint().ToString(), *header.Fingerprint.ToString());
+        return false;
+    }
+
+    Clear();
+    FinishPopulation();
+
+    SetActorTransform(header.GridTransform);
+
+    m_dragEnabled = true;
+    m_rotateEnabled = true;
+    m_toolboxEnabled = true;
+
+    // As the game mode builds it (see APPipesGameMode::Tick)
+    if (header.BuildSolution)
+    {
+        InitializeToolbox(std::vector<PipeSegmentGenerated>(), options.PlaySpaceSize);
+        AddPipes(generator.VirtualPipes, AddPipeOptions::None);
+    }
+    else
+    {
+        InitializeToolbox(generator.VirtualPipes, options.PlaySpaceSize);
+    }
+
+    AddPipes(generator.RealizedPipes, AddPipeOptions::Fixed);
+    AddPipes(header.Placed, AddPipeOptions::FromToolbox);
+
+    FinalizeLevel();
+
+    // Replayed frames don't tick the grid, and the recording has to start from a resolved level
+    UpdateAsyncResolve(true /* wait */);
+
+    if (header.HaveToolboxCoordinate)
+    {
+        TrySetToolboxCoordinate(header.ToolboxCoordinate);
+    }
+
+    FlushPipeEvents();
+    return true;
+}
+
+void APPipeGrid::ApplyRecordedEnabled(InteractionEnabledFlags enabled)
+{
+    SetInteractionEnabled(IsAnyFlagSet(enabled, InteractionEnabledFlags::Interaction));
+    SetDragEnabled(IsAnyFlagSet(enabled, InteractionEnabledFlags::Drag));
+    SetRotateEnabled(IsAnyFlagSet(enabled, InteractionEnabledFlags::Rotate));
+    SetToolboxEnabled(IsAnyFlagSet(enabled, InteractionEnabledFlags::Toolbox));
+}
+
+#endif
+
+bool APPipeGrid::ReplayInput(const FString& path, const FString& csvPath)
+{
+#if UE_BUILD_SHIPPING
+    return false;
+#else
+    if (m_replay.Recording || m_replay.Replaying)
+    {
+        UE_LOG(HoloPipesLog, Error, L"APPipeGrid::ReplayInput - Can't replay while recording or replaying");
+        return false;
+    }
+
+    InteractionLog log;
+    if (!log.Load(path))
+    {
+        UE_LOG(HoloPipesLog, Error, L"APPipeGrid::ReplayInput - Unable to read %s", *path);
+        return false;
+    }
+
+    if (!RebuildRecordedLevel(log.Header))
+    {
+        return false;
+    }
+
+    std::vector<ProfileFrame> frames;
+    std::vector<float> frameTimes;
+
+    FrameProfiler& profiler = FrameProfiler::Get();
+    ProfileFrame frame;
+    bool inFrame = false;
+    bool placingWorld = false;
+
+    // Gaze arrives first every frame, so each one ends the frame before it. What the grid does at the end
+    // of its tick (see Tick) is part of the frame too
+    auto endFrame = [&]()
+    {
+        UpdatePopulation();
+        UpdateAsyncResolve(false /* wait */);
+        FlushPipeEvents();
+
+        profiler.TakeFrame(frame);
+        frames.push_back(frame);
+        inFrame = false;
+    };
+
+    m_replay.Replaying = true;
+    const double start = FPlatformTime::Seconds();
+
+    for (const InteractionRecord& record : log.Records)
+    {
+        m_replay.Time = record.Time;
+
+        switch (record.Type)
+        {
+            case InteractionRecordType::Gaze:
+                if (inFrame)
+                {
+                    endFrame();
+                }
+                else
+                {
+                    // Rebuilding the level isn't part of any frame
+                    profiler.TakeFrame(frame);
+                }
+
+                frameTimes.push_back(record.Time);
+                inFrame = true;
+
+                HandlePawnGazeUpdate(record.Gaze);
+                break;
+
+            case InteractionRecordType::Gesture:
+                // Placing the grid needs the pawn, and its effect was recorded as grid transforms
+                if (!placingWorld)
+                {
+                    HandlePawnGestureUpdate(record.Gesture);
+                }
+                break;
+
+            case InteractionRecordType::GridTransform:
+                SetActorTransform(record.GridTransform);
+                break;
+
+            case InteractionRecordType::Enabled:
+                ApplyRecordedEnabled(record.Enabled);
+                placingWorld = IsAnyFlagSet(record.Enabled, InteractionEnabledFlags::PlaceWorld);
+                break;
+        }
+    }
+
+    if (inFrame)
+    {
+        endFrame();
+    }
+
+    const double seconds = FPlatformTime::Seconds() - start;
+    const float recordedSeconds = log.Records.empty() ? 0.0f : log.Records.back().Time;
+
+    m_replay.Replaying = false;
+
+    UE_LOG(HoloPipesLog, Display, L"APPipeGrid::ReplayInput - Replayed %d frames (%.2f seconds of input) in %.3f seconds, %.1fx real time",
+        static_cast<int32>(frames.size()), recordedSeconds, seconds, (seconds > 0.0) ? (recordedSeconds / seconds) : 0.0);
+
+    // Everything the grid does is timed, but only the scopes that saw any time are reported
+    const int scopeCount = static_cast<int>(ProfileScope::Count);
+    std::vector<double> values(frames.size());
+
+    for (int scope = 0; scope <= scopeCount; scope++)
+    {
+        double total = 0.0;
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            values[i] = FrameProfiler::CyclesToMs((scope < scopeCount) ? frames[i].Cycles[scope] : frames[i].FrameCycles) * 1000.0;
+            total += values[i];
+        }
+
+        if (scope < scopeCount && total <= 0.0)
+        {
+            continue;
+        }
+
+        const double mean = frames.empty() ? 0.0 : (total / frames.size());
+        const double max = values.empty() ? 0.0 : *std::max_element(values.begin(), values.end());
+        const double p95 = Percentile(values, 0.95);
+
+        UE_LOG(HoloPipesLog, Display, L"APPipeGrid::ReplayInput - %-16s mean %8.2f us, 95th percentile %8.2f us, max %8.2f us",
+            (scope < scopeCount) ? FrameProfiler::GetScopeName(static_cast<ProfileScope>(scope)) : L"Frame", mean, p95, max);
+    }
+
+    if (!csvPath.IsEmpty())
+    {
+        FString csv = L"Frame,Time";
+        for (int scope = 0; scope < scopeCount; scope++)
+        {
+            csv += FString::Printf(L",%sUs", FrameProfiler::GetScopeName(static_cast<ProfileScope>(scope)));
+        }
+
+        csv += L",FrameUs\n";
+
+        for (size_t i = 0; i < frames.size(); i++)
+        {
+            csv += FString::Printf(L"%d,%.4f", static_cast<int32>(i), frameTimes[i]);
+            for (uint64 cycles : frames[i].Cycles)
+            {
+                csv += FString::Printf(L",%.2f", FrameProfiler::CyclesToMs(cycles) * 1000.0);
+            }
+
+            csv += FString::Printf(L",%.2f\n", FrameProfiler::CyclesToMs(frames[i].FrameCycles) * 1000.0);
+        }
+
+        if (!FFileHelper::SaveStringToFile(csv, *csvPath))
+        {
+            UE_LOG(HoloPipesLog, Error, L"APPipeGrid::ReplayInput - Unable to write %s", *csvPath);
+        }
+    }
+
+    return true;
+#endif
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include "PPipe.h"
+#include "PMRPawn.h"
+#include "LevelGenerator.h"
+#include <vector>
+
+// What it takes to rebuild the level a recording was made on: the options it was generated with
+// (and its fingerprint, to check the generator still makes the same level), the pipes the player
+// had placed when recording started, and the state of the grid around it
+struct InteractionLogHeader
+{
+    FGenerateOptions Options = {};
+    bool BuildSolution = false;
+    LevelFingerprint Fingerprint;
+
+    std::vector<PipeSegmentGenerated> Placed;
+
+    bool HaveToolboxCoordinate = false;
+    FPipeGridCoordinate ToolboxCoordinate = FPipeGridCoordinate::Zero;
+
+    FTransform GridTransform = FTransform::Identity;
+};
+
+enum class InteractionRecordType : uint8
+{
+    // Starts a frame, since the pawn sends the gaze first every frame
+    Gaze,
+    Gesture,
+
+    // The grid was moved (see PPipeGrid_PlaceWorld)
+    GridTransform,
+
+    // Interaction, drag, rotate or the toolbox was turned on or off
+    Enabled
+};
+
+enum class InteractionEnabledFlags : uint8
+{
+    None        = 0x00,
+    Interaction = 0x01,
+    Drag        = 0x02,
+    Rotate      = 0x04,
+    Toolbox     = 0x08,
+
+    // The grid was being placed, so gestures went to placement rather than the pipes
+    PlaceWorld  = 0x10
+};
+
+DEFINE_ENUM_FLAG_OPERATORS(InteractionEnabledFlags);
+
+struct InteractionRecord
+{
+    InteractionRecordType Type = InteractionRecordType::Gaze;
+
+    // Seconds since recording started
+    float Time = 0.0f;
+
+    FGazeUpdate Gaze = {};
+    FGestureUpdate Gesture = {};
+    FTransform GridTransform = FTransform::Identity;
+    InteractionEnabledFlags Enabled = InteractionEnabledFlags::None;
+};
+
+// A recorded session, as saved to and loaded from disk. Records are stored in the order the grid
+// received them, with the hand transforms' scale only written when it isn't 1
+struct InteractionLog
+{
+    InteractionLogHeader Header;
+    std::vector<InteractionRecord> Records;
+
+    bool Save(const FString& path) const;
+    bool Load(const FString& path);
+};
+
+struct InteractionReplayState
+{
+    // Recording
+    InteractionLog Log;
+    bool Recording = false;
+    float RecordingStart = 0.0f;
+    FTransform RecordedTransform = FTransform::Identity;
+    InteractionEnabledFlags RecordedEnabled = InteractionEnabledFlags::None;
+
+    // Replaying
+    bool Replaying = false;
+    float Time = 0.0f;
+};
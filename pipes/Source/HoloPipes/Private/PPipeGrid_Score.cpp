@@ -1,64 +1,91 @@
-
-#include "PPipeGrid_Score.h"
-#include "PPipeGrid_Internal.h"
-
-static constexpr int32 MaxScorePipeAge = 1;
-
-// The Level Score should increase with each manipulation of a unique pipe, As long a
-// either hand keeps manipulating the last manipulated piece, the score should not
-// increase.
-// 
-// This is complicated by the fact that we can use two hands simultaneously. We don't
-// want the score to increase if we're using the last pipe recently manipulated by either
-// hand, but also don't want an infrequently used hand to pick up a pipe used "a while
-// ago," for free after the frequently used hand has manipulated multiple pipe pieces.
-//
-// We accomplish this by keeping track of the last pipe manipulated by both hands, but
-// also tracking the "Age" of the pipe (or how many times hand B has dropped a pipe since
-// hand A last did), and clearing out the pipe when it gets too old
-
-void APPipeGrid::ScoreHandGrasp(EFingerHand hand, const APPipe* graspedPipe)
-{
-    // Picking up a pipe is free as long as it was the last pipe picked up by either 
-    // hand. Otherwise, it increments the score
-    if (graspedPipe)
-    {
-        if (graspedPipe != m_score.Hands[0].Pipe && graspedPipe != m_score.Hands[1].Pipe)
-        {
-            m_score.CurrentScore++;
-        }
-    }
-}
-
-void APPipeGrid::ScoreHandRelease(EFingerHand hand, const APPipe* releasedPipe)
-{
-    if (releasedPipe)
-    {
-        int currentHandNum = (int)hand;
-        auto& currentHand = m_score.Hands[currentHandNum];
-        auto& otherHand = m_score.Hands[(currentHandNum + 1) % 2];
-
-        currentHand.Age = 0;
-        currentHand.Pipe = releasedPipe;
-
-        if (otherHand.Pipe != nullptr)
-        {
-            otherHand.Age++;
-            if (otherHand.Age > MaxScorePipeAge)
-            {
-                otherHand.Age = 0;
-                otherHand.Pipe = nullptr;
-            }
-        }
-    }
-}
-
-int32 APPipeGrid::GetCurrentLevelScore()
-{
-    return m_score.CurrentScore;
-}
-
-void APPipeGrid::ClearCurrentLevelScore()
-{
-    m_score = {};
-}
+
+#include "PPipeGrid_Score.h"
+#include "PPipeGrid_Internal.h"
+
+static constexpr int32 MaxScorePipeAge = 1;
+
+// The Level Score should increase with each manipulation of a unique pipe, As long a
+// either hand keeps manipulating the last manipulated piece, the score should not
+// increase.
+// 
+// This is complicated by the fact that we can use two hands simultaneously. We don't
+// want the score to increase if we're using the last pipe recently manipulated by either
+// hand, but also don't want an infrequently used hand to pick up a pipe used "a while
+// ago," for free after the frequently used hand has manipulated multiple pipe pieces.
+//
+// We accomplish this by keeping track of the last pipe manipulated by both hands, but
+// also tracking the "Age" of the pipe (or how many times hand B has dropped a pipe since
+// hand A last did), and clearing out the pipe when it gets too old
+
+bool APPipeGrid::ScoreHandGrasp(EFingerHand hand, const APPipe* graspedPipe)
+{
+    // Picking up a pipe is free as long as it was the last pipe picked up by either 
+    // hand. Otherwise, it increments the score
+    if (graspedPipe)
+    {
+        if (graspedPipe != m_score.Hands[0].Pipe && graspedPipe != m_score.Hands[1].Pipe)
+        {
+            m_score.CurrentScore++;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void APPipeGrid::ScoreHandRelease(EFingerHand hand, const APPipe* releasedPipe)
+{
+    if (releasedPipe)
+    {
+        int currentHandNum = (int)hand;
+        auto& currentHand = m_score.Hands[currentHandNum];
+        auto& otherHand = m_score.Hands[(currentHandNum + 1) % 2];
+
+        currentHand.Age = 0;
+        currentHand.Pipe = releasedPipe;
+
+        if (otherHand.Pipe != nullptr)
+        {
+            otherHand.Age++;
+            if (otherHand.Age > MaxScorePipeAge)
+            {
+                otherHand.Age = 0;
+                otherHand.Pipe = nullptr;
+            }
+        }
+    }
+}
+
+// With Refund, undoing a change takes back the grasps that made it, so undoing a misplaced pipe
+// costs nothing beyond placing it again properly
+void APPipeGrid::ScoreUndo(int32 scoredGrasps, bool undo)
+{
+    switch (UndoScoring)
+    {
+        case EUndoScoring::Refund:
+            m_score.CurrentScore = FMath::Max(0, m_score.CurrentScore + (undo ? -scoredGrasps : scoredGrasps));
+            break;
+
+        case EUndoScoring::Penalty:
+            m_score.CurrentScore += UndoScorePenalty;
+            break;
+
+        default:
+            break;
+    }
+
+    // The pipes the hands last moved may have been put back or released, so the next grasp is scored
+    // on its own
+    m_score.Hands[0] = {};
+    m_score.Hands[1] = {};
+}
+
+int32 APPipeGrid::GetCurrentLevelScore()
+{
+    return m_score.CurrentScore;
+}
+
+void APPipeGrid::ClearCurrentLevelScore()
+{
+    m_score = {};
+}
@@ -0,0 +1,263 @@
+#pragma once
+
+#include "PPipe.h"
+#include <vector>
+#include <unordered_map>
+#include <utility>
+#include <algorithm>
+#include <iterator>
+
+// Holds the pipes in the grid, keyed by grid coordinate. Coordinates are indexed by bricks of
+// BrickSide cells on a side, which are allocated as the first entry lands in them and freed with
+// the last, so memory follows the pipes rather than the volume they're spread over and any
+// coordinate FPipeGridCoordinate can hold works. Lookups go through a hash of the occupied bricks,
+// skipped when they land in the same brick as the last one (neighbor lookups nearly always do).
+// The entries themselves are packed, so iterating only touches occupied cells.
+//
+// This supports the part of std::unordered_map that the grid uses. The one difference is that
+// erasing moves the last entry into the erased slot, so pointers and references to entries are
+// only good until the next insert or erase.
+template <class TValue>
+class PipeGridStorage
+{
+public:
+
+    using value_type = std::pair<FPipeGridCoordinate, TValue>;
+
+    template <class TOwner, class TEntry>
+    class IteratorOf
+    {
+    public:
+
+        IteratorOf(TOwner* owner, size_t index) : m_owner(owner), m_index(index) {}
+
+        TEntry& operator*() const { return m_owner->m_entries[m_index]; }
+        TEntry* operator->() const { return &m_owner->m_entries[m_index]; }
+
+        IteratorOf& operator++() { m_index++; return *this; }
+        IteratorOf operator++(int) { IteratorOf previous = *this; m_index++; return previous; }
+
+        bool operator==(const IteratorOf& other) const { return m_index == other.m_index; }
+        bool operator!=(const IteratorOf& other) const { return m_index != other.m_index; }
+
+    private:
+
+        friend class PipeGridStorage;
+
+        TOwner* m_owner;
+        size_t m_index;
+    };
+
+    using iterator = IteratorOf<PipeGridStorage, value_type>;
+    using const_iterator = IteratorOf<const PipeGridStorage, const value_type>;
+
+    static constexpr int32 BrickBits = 3;
+    static constexpr int32 BrickSide = 1 << BrickBits;
+    static constexpr int32 BrickCells = BrickSide * BrickSide * BrickSide;
+
+    iterator begin() { return iterator(this, 0); }
+    iterator end() { return iterator(this, m_entries.size()); }
+    const_iterator begin() const { return const_iterator(this, 0); }
+    const_iterator end() const { return const_iterator(this, m_entries.size()); }
+
+    size_t size() const { return m_entries.size(); }
+    bool empty() const { return m_entries.empty(); }
+
+    iterator find(const FPipeGridCoordinate& key)
+    {
+        int32 index = IndexOf(key);
+        return (index == NoEntry) ? end() : iterator(this, index);
+    }
+
+    const_iterator find(const FPipeGridCoordinate& key) const
+    {
+        int32 index = IndexOf(key);
+        return (index == NoEntry) ? end() : const_iterator(this, index);
+    }
+
+    TValue& operator[](const FPipeGridCoordinate& key)
+    {
+        int32 index = IndexOf(key);
+        if (index == NoEntry)
+        {
+            index = static_cast<int32>(m_entries.size());
+            m_entries.emplace_back(key, TValue());
+            SetIndex(key, index);
+        }
+
+        return m_entries[index].second;
+    }
+
+    // Returns an iterator to the entry that took the erased one's place
+    iterator erase(iterator it)
+    {
+        size_t index = it.m_index;
+        size_t last = m_entries.size() - 1;
+
+        ClearIndex(m_entries[index].first);
+
+        if (index != last)
+        {
+            m_entries[index] = std::move(m_entries[last]);
+            SetIndex(m_entries[index].first, static_cast<int32>(index));
+        }
+
+        m_entries.pop_back();
+        return iterator(this, index);
+    }
+
+    size_t erase(const FPipeGridCoordinate& key)
+    {
+        iterator it = find(key);
+        if (it == end())
+        {
+            return 0;
+        }
+
+        erase(it);
+        return 1;
+    }
+
+    // Keeps the bricks allocated so far, for the next level to reuse
+    void clear()
+    {
+        m_entries.clear();
+        m_brickIndex.clear();
+        m_freeBricks.clear();
+
+        for (int32 brick = static_cast<int32>(m_bricks.size()) - 1; brick >= 0; brick--)
+        {
+            m_freeBricks.push_back(brick);
+        }
+
+        m_lastBrick = NoEntry;
+        m_lastBrickKey = { 0, 0, 0 };
+    }
+
+    // Bricks in use, each of which costs BrickCells indices
+    size_t brick_count() const { return m_bricks.size() - m_freeBricks.size(); }
+
+private:
+
+    struct CoordinateHash
+    {
+        size_t operator()(const FPipeGridCoordinate& loc) const
+        {
+            return FPipeGridCoordinate::HashOf(loc);
+        }
+    };
+
+    static constexpr int32 NoEntry = -1;
+
+    struct Brick
+    {
+        int32 Cells[BrickCells];
+        int32 Occupied;
+    };
+
+    // Arithmetic shifts round toward negative infinity, so negative coordinates land in the right brick
+    static FPipeGridCoordinate BrickOf(const FPipeGridCoordinate& key)
+    {
+        return { key.X >> BrickBits, key.Y >> BrickBits, key.Z >> BrickBits };
+    }
+
+    static int32 CellOf(const FPipeGridCoordinate& key)
+    {
+        constexpr int32 mask = BrickSide - 1;
+        return ((key.Z & mask) << (2 * BrickBits)) | ((key.Y & mask) << BrickBits) | (key.X & mask);
+    }
+
+    // Returns the brick holding the coordinate, or -1 if none has been allocated
+    int32 FindBrick(const FPipeGridCoordinate& key) const
+    {
+        FPipeGridCoordinate brickKey = BrickOf(key);
+        if (brickKey != m_lastBrickKey)
+        {
+            auto it = m_brickIndex.find(brickKey);
+
+            m_lastBrickKey = brickKey;
+            m_lastBrick = (it == m_brickIndex.end()) ? NoEntry : it->second;
+        }
+
+        return m_lastBrick;
+    }
+
+    int32 AllocateBrick(const FPipeGridCoordinate& key)
+    {
+        int32 brick;
+        if (m_freeBricks.empty())
+        {
+            brick = static_cast<int32>(m_bricks.size());
+            m_bricks.emplace_back();
+        }
+        else
+        {
+            brick = m_freeBricks.back();
+            m_freeBricks.pop_back();
+        }
+
+        std::fill(std::begin(m_bricks[brick].Cells), std::end(m_bricks[brick].Cells), NoEntry);
+        m_bricks[brick].Occupied = 0;
+
+        m_lastBrickKey = BrickOf(key);
+        m_lastBrick = brick;
+        m_brickIndex[m_lastBrickKey] = brick;
+
+        return brick;
+    }
+
+    int32 IndexOf(const FPipeGridCoordinate& key) const
+    {
+        int32 brick = FindBrick(key);
+        return (brick == NoEntry) ? NoEntry : m_bricks[brick].Cells[CellOf(key)];
+    }
+
+    void SetIndex(const FPipeGridCoordinate& key, int32 index)
+    {
+        int32 brick = FindBrick(key);
+        if (brick == NoEntry)
+        {
+            brick = AllocateBrick(key);
+        }
+
+        int32& cell = m_bricks[brick].Cells[CellOf(key)];
+        if (cell == NoEntry)
+        {
+            m_bricks[brick].Occupied++;
+        }
+
+        cell = index;
+    }
+
+    void ClearIndex(const FPipeGridCoordinate& key)
+    {
+        int32 brick = FindBrick(key);
+        if (brick == NoEntry)
+        {
+            return;
+        }
+
+        int32& cell = m_bricks[brick].Cells[CellOf(key)];
+        if (cell != NoEntry)
+        {
+            cell = NoEntry;
+
+            if (--m_bricks[brick].Occupied == 0)
+            {
+                m_brickIndex.erase(m_lastBrickKey);
+                m_freeBricks.push_back(brick);
+                m_lastBrick = NoEntry;
+            }
+        }
+    }
+
+    std::vector<value_type> m_entries;
+
+    std::vector<Brick> m_bricks;
+    std::vector<int32> m_freeBricks;
+    std::unordered_map<FPipeGridCoordinate, int32, CoordinateHash> m_brickIndex;
+
+    // The last brick looked up (or found missing), which the next lookup usually wants too
+    mutable FPipeGridCoordinate m_lastBrickKey = { 0, 0, 0 };
+    mutable int32 m_lastBrick = NoEntry;
+};
@@ -41,9 +41,9 @@ bool APPipeGrid::GetToolboxCoordinate(FPipeGridCoordinate* pCoord)
     (*pCoord) = FPipeGridCoordinate::Zero;
     bool valid = false;
 
-    if (m_toolboxEnabled && Toolbox && !IsToolboxDragging())
+    if (m_toolboxEnabled && Toolbox && m_haveToolboxRoot && !IsToolboxDragging())
     {
-        (*pCoord) = GridLocationToGridCoordinate(WorldLocationToGridLocation(Toolbox->GetActorLocation()));
+        (*pCoord) = m_toolboxRoot;
         valid = true;
     }
 
@@ -82,10 +82,9 @@ void APPipeGrid::LiftToolbox()
                 if (it->second.pipe)
                 {
                     it->second.pipe->AttachToComponent(Toolbox->GetRootComponent(), FAttachmentTransformRules::KeepWorldTransform);
-                    it->second.pipe = nullptr;
                 }
 
-                m_pipesGrid.erase(it);
+                EraseGridPipe(it);
             }
         }
     }
@@ -97,7 +96,7 @@ bool APPipeGrid::TryHandleStartToolboxDrag(GridHandState& handState)
 
     if (!IsToolboxDragging() && ToolboxCoordinateForType(EPipeType::Start, &top) && top == handState.Pipe.StartCoordinate)
     {
-        handState.Toolbox.StartCoordinate = GridLocationToGridCoordinate(WorldLocationToGridLocation(Toolbox->GetActorLocation()));
+        handState.Toolbox.StartCoordinate = m_toolboxRoot;
 
         // We always assume the current position of the toolbox is safe (since nothing should currently block it there).
         handState.Toolbox.LastSafeCoordinate = handState.Toolbox.StartCoordinate;
@@ -163,6 +162,9 @@ void APPipeGrid::DropToolbox(FPipeGridCoordinate root)
     const FVector newLocation = GridCoordinateToGridLocation(root);
     Toolbox->SetActorRelativeLocation(newLocation);
 
+    m_toolboxRoot = root;
+    m_haveToolboxRoot = true;
+
     TArray<AActor*> children;
     Toolbox->GetAttachedActors(children);
 
@@ -179,7 +181,7 @@ void APPipeGrid::DropToolbox(FPipeGridCoordinate root)
                 gridPipe.pipe = childPipe;
                 gridPipe.currentLocation = GridLocationToGridCoordinate(gridLocation);
                 gridPipe.currentPipeClass = childPipe->GetPipeClass();
-                m_pipesGrid[gridPipe.currentLocation] = gridPipe;
+                PutGridPipe(gridPipe);
 
                 childPipe->AttachToComponent(RootComponent, FAttachmentTransformRules::KeepRelativeTransform);
 
@@ -207,6 +209,7 @@ void APPipeGrid::HandleToolboxDragLost(GridHandState& handState)
         // only be dropping someplace with pipes if its our start coordinate,
         // which means that it should be safe to put any pipes that were dropped
         // there while we were dragging back into the toolbox.
+        bool returnedPipes = false;
         for (auto type : ValidToolboxTypes)
         {
             FPipeGridCoordinate victim;
@@ -232,17 +235,29 @@ void APPipeGrid::HandleToolboxDragLost(GridHandState& handState)
                                 break;
                         }
 
-                        it->second.pipe->Destroy();
+                        ReleasePipe(it->second.pipe);
                         it->second.pipe = nullptr;
+                        returnedPipes = true;
                     }
 
-                    m_pipesGrid.erase(it);
+                    MarkConnectivityDirty(victim);
+                    EraseGridPipe(it);
                 }
             }
         }
 
         DropToolbox(dropCoordinate);
 
+        if (returnedPipes)
+        {
+            // The journal would put them back where the toolbox now sits
+            ClearJournal();
+        }
+        else
+        {
+            JournalToolboxMove(handState.Toolbox.StartCoordinate, dropCoordinate);
+        }
+
         if (dropCoordinate != handState.Toolbox.StartCoordinate)
         {
             OnToolboxMoved.Broadcast();
@@ -301,6 +316,7 @@ void APPipeGrid::SpawnInToolbox(EPipeType toolboxPipe)
                 if (it != m_pipesGrid.end() && it->second.pipe)
                 {
                     it->second.pipe->SetPipeFixed(fixed);
+                    IndexPipe(it->second);
                     found = true;
                 }
             }
@@ -364,12 +380,10 @@ bool APPipeGrid::DoesToolboxFitAt(FPipeGridCoordinate root)
 
 bool APPipeGrid::ToolboxCoordinateForType(EPipeType type, FPipeGridCoordinate* pCoord)
 {
-    if (m_toolboxEnabled && Toolbox && !IsToolboxDragging())
+    FPipeGridCoordinate root;
+    if (GetToolboxCoordinate(&root))
     {
-        return ToolboxCoordinateForType(
-            type,
-            GridLocationToGridCoordinate(WorldLocationToGridLocation(Toolbox->GetActorLocation())),
-            pCoord);
+        return ToolboxCoordinateForType(type, root, pCoord);
     }
 
     return false;
@@ -414,20 +428,26 @@ bool APPipeGrid::ToolboxCoordinateForType(EPipeType type, FPipeGridCoordinate ro
 
 bool APPipeGrid::CoordinateInToolbox(const FPipeGridCoordinate& coordinate)
 {
-    for (EPipeType type : ValidToolboxTypes)
-    {
-        FPipeGridCoordinate toolboxCoordinate;
-        if (ToolboxCoordinateForType(type, &toolboxCoordinate) && toolboxCoordinate == coordinate)
-        {
-            return true;
-        }
-    }
-
-    return false;
+    // The toolbox is a column, from End two below its root up to Start two above it (see
+    // ToolboxCoordinateForType)
+    FPipeGridCoordinate root;
+    return GetToolboxCoordinate(&root) &&
+        coordinate.X == root.X &&
+        coordinate.Y == root.Y &&
+        coordinate.Z >= root.Z - 2 &&
+        coordinate.Z <= root.Z + 2;
 }
 
 void APPipeGrid::InitializeToolbox(const std::vector<PipeSegmentGenerated>& pipesInToolbox, int playableGridSize)
 {
+    // The play area gaze is traced through, with a margin around it wide enough to cover the
+    // toolbox's starting position (see GetDefaultToolboxCoordinate) even on small grids
+    int gridSide = playableGridSize + 2;
+    int gridMin = -(gridSide / 2) - 2;
+    int gridMax = gridMin + gridSide + 4;
+    m_playBoundsMin = { gridMin, gridMin, gridMin };
+    m_playBoundsMax = { gridMax, gridMax, gridMax };
+
     if (m_toolboxEnabled)
     {
         if (!Toolbox && ToolboxClass)
@@ -445,7 +465,10 @@ void APPipeGrid::InitializeToolbox(const std::vector<PipeSegmentGenerated>& pipe
             Toolbox->Clear();
             Toolbox->Initialize(pipesInToolbox);
 
-            Toolbox->SetActorRelativeLocation(GridCoordinateToGridLocation(GetDefaultToolboxCoordinate(playableGridSize)));
+            m_toolboxRoot = GetDefaultToolboxCoordinate(playableGridSize);
+            m_haveToolboxRoot = true;
+
+            Toolbox->SetActorRelativeLocation(GridCoordinateToGridLocation(m_toolboxRoot));
             Toolbox->SetActorRelativeScale3D({ 1,1,1 });
 
             InitializeToolboxPipes();
@@ -483,6 +506,7 @@ void APPipeGrid::RemoveToolbox()
     {
         Toolbox->Destroy();
         Toolbox = nullptr;
+        m_haveToolboxRoot = false;
     }
 }
 
@@ -497,48 +521,51 @@ void APPipeGrid::InitializeToolboxPipes()
     GridPipe reservedBelowToolbox = reservedAboveToolbox;
 
     ToolboxCoordinateForType(EPipeType::Start, &reservedAboveToolbox.currentLocation);
-    m_pipesGrid[reservedAboveToolbox.currentLocation] = reservedAboveToolbox;
+    PutGridPipe(reservedAboveToolbox);
 
     ToolboxCoordinateForType(EPipeType::End, &reservedBelowToolbox.currentLocation);
-    m_pipesGrid[reservedBelowToolbox.currentLocation] = reservedBelowToolbox;
+    PutGridPipe(reservedBelowToolbox);
 }
 
 void APPipeGrid::ReturnDisconnectedToToolbox()
 {
     if (Toolbox)
     {
-        std::vector<FPipeGridCoordinate> victims;
+        // Copied, since the set changes as the victims are erased
+        std::vector<FPipeGridCoordinate> victims = m_pipeSets[static_cast<int>(GridPipeSet::PlacedDisconnected)];
 
-        auto it = m_pipesGrid.begin();
-        while (it != m_pipesGrid.end())
+        for (const FPipeGridCoordinate& victim : victims)
         {
-            if (it->second.pipe && 
-                !it->second.pipe->GetPipeFixed() &&
-                !it->second.pipe->GetInToolbox() && 
-                it->second.pipe->GetPipeClass() == DefaultPipeClass)
-            {
-                victims.push_back(it->first);
+            const APPipe* pipe = m_pipesGrid.find(victim)->second.pipe;
+            EPipeType type = pipe->GetPipeType();
 
-                EPipeType type = it->second.pipe->GetPipeType();
-                Toolbox->AddPipe(type);
+            // The whole sweep is undone at once
+            GridJournalEntry entry;
+            entry.Op = GridJournalOp::Return;
+            entry.Grouped = (&victim != &victims.front());
+            entry.Type = type;
+            entry.From = victim;
+            entry.DirectionsBefore = pipe->GetPipeDirections();
+            JournalChange(entry);
 
-                if (Toolbox->CountRemaining(type) == 1)
-                {
-                    // We just went from 0 to 1, so respawn the pipe
-                    SpawnInToolbox(type);
-                }
-            }
+            Toolbox->AddPipe(type);
 
-            it++;
+            if (Toolbox->CountRemaining(type) == 1)
+            {
+                // We just went from 0 to 1, so respawn the pipe
+                SpawnInToolbox(type);
+            }
         }
 
         // Now destroy all placed victims
         auto itVictim = victims.begin();
         while (itVictim != victims.end())
         {
+            MarkConnectivityDirty(*itVictim);
+
             auto itVictimInGrid = m_pipesGrid.find(*itVictim);
-            itVictimInGrid->second.pipe->Destroy();
-            m_pipesGrid.erase(itVictimInGrid);
+            ReleasePipe(itVictimInGrid->second.pipe);
+            EraseGridPipe(itVictimInGrid);
 
             itVictim++;
         }
@@ -0,0 +1,163 @@
+#include "SeedMetrics.h"
+
+namespace
+{
+    int CountPipes(const GeneratedLevel& level, EPipeType typeMask)
+    {
+        int count = 0;
+
+        for (const auto* pipes : { &level.VirtualPipes, &level.RealizedPipes })
+        {
+            for (const auto& segment : *pipes)
+            {
+                if ((segment.Type & typeMask) != EPipeType::None)
+                {
+                    count++;
+                }
+            }
+        }
+
+        return count;
+    }
+
+    // Every piece between the starts and ends
+    class PathLengthMetric : public SeedMetric
+    {
+    public:
+        virtual const TCHAR* GetName() const override { return L"PathLength"; }
+
+        virtual float Measure(const GeneratedLevel& level) const override
+        {
+            return static_cast<float>(CountPipes(level, EPipeType::Straight | EPipeType::Corner | EPipeType::Junction));
+        }
+    };
+
+    class TurnsMetric : public SeedMetric
+    {
+    public:
+        virtual const TCHAR* GetName() const override { return L"Turns"; }
+
+        virtual float Measure(const GeneratedLevel& level) const override
+        {
+            return static_cast<float>(CountPipes(level, EPipeType::Corner));
+        }
+    };
+
+    class JunctionsMetric : public SeedMetric
+    {
+    public:
+        virtual const TCHAR* GetName() const override { return L"Junctions"; }
+
+        virtual float Measure(const GeneratedLevel& level) const override
+        {
+            return static_cast<float>(CountPipes(level, EPipeType::Junction));
+        }
+    };
+
+    // How far junctions sit from the nearest face of the play space, on average. Junctions buried in
+    // the middle of the level are harder to spot than ones hugging a wall
+    class JunctionDepthMetric : public SeedMetric
+    {
+    public:
+        virtual const TCHAR* GetName() const override { return L"JunctionDepth"; }
+
+        virtual float Measure(const GeneratedLevel& level) const override
+        {
+            // Matches the grid LevelGenerator builds (starts and ends sit one outside the play space)
+            const int gridSide = level.Options.PlaySpaceSize + 2;
+            const int sideMin = -gridSide / 2;
+            const int sideMax = sideMin + gridSide - 1;
+
+            int junctions = 0;
+            int totalDepth = 0;
+
+            for (const auto* pipes : { &level.VirtualPipes, &level.RealizedPipes })
+            {
+                for (const auto& segment : *pipes)
+                {
+                    if (segment.Type == EPipeType::Junction)
+                    {
+                        const FPipeGridCoordinate& location = segment.Location;
+                        totalDepth += std::min({
+                            location.X - sideMin, sideMax - location.X,
+                            location.Y - sideMin, sideMax - location.Y,
+                            location.Z - sideMin, sideMax - location.Z });
+                        junctions++;
+                    }
+                }
+            }
+
+            return (junctions > 0) ? (static_cast<float>(totalDepth) / junctions) : 0.0f;
+        }
+    };
+
+    class ParMetric : public SeedMetric
+    {
+    public:
+        virtual const TCHAR* GetName() const override { return L"Par"; }
+        virtual bool NeedsParScore() const override { return true; }
+
+        virtual float Measure(const GeneratedLevel& level) const override
+        {
+            return static_cast<float>(level.ParScore);
+        }
+    };
+}
+
+std::unique_ptr<SeedMetric> CreateSeedMetric(const FString& name)
+{
+    std::unique_ptr<SeedMetric> metrics[] =
+    {
+        std::make_unique<PathLengthMetric>(),
+        std::make_unique<TurnsMetric>(),
+        std::make_unique<JunctionsMetric>(),
+        std::make_unique<JunctionDepthMetric>(),
+        std::make_unique<ParMetric>()
+    };
+
+    for (auto& metric : metrics)
+    {
+        if (name.Equals(metric->GetName(), ESearchCase::IgnoreCase))
+        {
+            return std::move(metric);
+        }
+    }
+
+    return nullptr;
+}
+
+FString GetSeedMetricNames()
+{
+    return L"PathLength, Turns, Junctions, JunctionDepth, Par";
+}
+
+bool ParseSeedMetrics(const FString& spec, std::vector<WeightedSeedMetric>& metrics)
+{
+    TArray<FString> entries;
+    spec.ParseIntoArray(entries, L",");
+
+    for (const FString& entry : entries)
+    {
+        FString name = entry.TrimStartAndEnd();
+        FString weight;
+
+        WeightedSeedMetric weighted;
+
+        if (entry.Split(L":", &name, &weight))
+        {
+            name = name.TrimStartAndEnd();
+            weighted.Weight = FCString::Atof(*weight);
+        }
+
+        weighted.Metric = CreateSeedMetric(name);
+        if (!weighted.Metric)
+        {
+            UE_LOG(HoloPipesLog, Error, L"SeedMetrics - Unknown metric '%s' (expected one of %s)", *name, *GetSeedMetricNames());
+            return false;
+        }
+
+        metrics.push_back(std::move(weighted));
+    }
+
+    return !metrics.empty();
+}
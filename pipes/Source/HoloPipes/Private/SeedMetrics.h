@@ -0,0 +1,41 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <memory>
+#include <vector>
+#include "LevelBatchGenerator.h"
+
+//
+// Measures one aspect of a generated level for USeedSearchCommandlet. Larger values mean "more"
+// of that aspect; the search multiplies each metric by its weight (negative to prefer less of it)
+// and ranks seeds by the sum.
+//
+// To add a metric, derive from SeedMetric and add it to CreateSeedMetric.
+//
+class SeedMetric
+{
+public:
+
+    virtual ~SeedMetric() = default;
+
+    virtual const TCHAR* GetName() const = 0;
+    virtual float Measure(const GeneratedLevel& level) const = 0;
+
+    // The solver only needs a budget when a metric looks at the par score
+    virtual bool NeedsParScore() const { return false; }
+};
+
+struct WeightedSeedMetric
+{
+    std::unique_ptr<SeedMetric> Metric;
+    float Weight = 1.0f;
+};
+
+// Returns nullptr if there is no metric with this name
+std::unique_ptr<SeedMetric> CreateSeedMetric(const FString& name);
+
+// Parses a list like "PathLength:1,Turns:-0.5,Par". A missing weight is 1
+bool ParseSeedMetrics(const FString& spec, std::vector<WeightedSeedMetric>& metrics);
+
+// Comma separated names of every metric CreateSeedMetric knows about
+FString GetSeedMetricNames();
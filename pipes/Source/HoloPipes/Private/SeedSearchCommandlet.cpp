@@ -0,0 +1,228 @@
+#include "SeedSearchCommandlet.h"
+#include "PPipesGameMode.h"
+#include "LevelBatchGenerator.h"
+#include "SeedMetrics.h"
+#include "Misc/Parse.h"
+#include "Misc/FileHelper.h"
+#include "HAL/PlatformTime.h"
+#include <deque>
+#include <algorithm>
+
+namespace
+{
+    struct SeedResult
+    {
+        int32 Seed = 0;
+        float Score = 0.0f;
+        LevelFingerprint Fingerprint;
+        std::vector<float> Values;
+    };
+
+    struct SeedResultCompare
+    {
+        // Orders the heap so the worst result we're keeping is on top
+        bool operator() (const SeedResult& lhs, const SeedResult& rhs) const
+        {
+            return (lhs.Score > rhs.Score) || (lhs.Score == rhs.Score && lhs.Seed < rhs.Seed);
+        }
+    };
+
+    // How many jobs we keep queued per worker. Enough that a worker never waits on us, without
+    // holding millions of futures (and their levels) at once
+    constexpr size_t c_JobsPerWorker = 4;
+
+    constexpr double c_ProgressSeconds = 5.0;
+}
+
+USeedSearchCommandlet::USeedSearchCommandlet()
+{
+    IsClient = false;
+    IsServer = false;
+    IsEditor = false;
+    LogToConsole = true;
+}
+
+int32 USeedSearchCommandlet::Main(const FString& params)
+{
+    int32 level = 1;
+    int32 firstSeed = 1;
+    int32 seedCount = 10000;
+    int32 topK = 10;
+    int32 workers = 0;
+    int32 memoryKB = 0;
+    FString metricSpec = L"PathLength:1,Turns:1";
+    FString gameModePath;
+    FString outputPath;
+
+    FParse::Value(*params, L"Level=", level);
+    FParse::Value(*params, L"FirstSeed=", firstSeed);
+    FParse::Value(*params, L"Seeds=", seedCount);
+    FParse::Value(*params, L"TopK=", topK);
+    FParse::Value(*params, L"Workers=", workers);
+    FParse::Value(*params, L"MemoryKB=", memoryKB);
+    FParse::Value(*params, L"Metrics=", metricSpec);
+    FParse::Value(*params, L"GameMode=", gameModePath);
+    FParse::Value(*params, L"Output=", outputPath);
+
+    // Tutorials treat a seed of 0 as "no seed"
+    if (firstSeed < 1 || seedCount < 1 || topK < 1 || level < 1)
+    {
+        UE_LOG(HoloPipesLog, Error, L"SeedSearch - Level, FirstSeed, Seeds and TopK must all be at least 1");
+        return 1;
+    }
+
+    std::vector<WeightedSeedMetric> metrics;
+    if (!ParseSeedMetrics(metricSpec, metrics))
+    {
+        UE_LOG(HoloPipesLog, Error, L"SeedSearch - Unable to parse -Metrics=%s", *metricSpec);
+        return 1;
+    }
+
+    // Use the rules from the game's game mode if we're given one, since its defaults may have been edited
+    APPipesGameMode* gameMode = GetMutableDefault<APPipesGameMode>();
+    if (!gameModePath.IsEmpty())
+    {
+        UClass* gameModeClass = LoadClass<APPipesGameMode>(nullptr, *gameModePath);
+        if (!gameModeClass)
+        {
+            UE_LOG(HoloPipesLog, Error, L"SeedSearch - Unable to load game mode %s", *gameModePath);
+            return 1;
+        }
+
+        gameMode = gameModeClass->GetDefaultObject<APPipesGameMode>();
+    }
+
+    FGenerateOptions options = {};
+    gameMode->BuildOptionsForLevel(level, options);
+
+    bool needsPar = false;
+    for (const auto& weighted : metrics)
+    {
+        needsPar = needsPar || weighted.Metric->NeedsParScore();
+    }
+
+    if (!needsPar)
+    {
+        // Don't spend time proving a par score nobody looks at
+        options.SolverBudgetMs = 0.0f;
+    }
+
+    LevelBatchGenerator batch(workers, memoryKB);
+
+    UE_LOG(HoloPipesLog, Display, L"SeedSearch - Level %d (play space %d, %d pipes), seeds %d to %d on %d workers",
+        level, options.PlaySpaceSize, options.MaxNumPipes, firstSeed, firstSeed + seedCount - 1, batch.GetWorkerCount());
+
+    // A heap rather than a priority_queue, since we need to look through it for duplicates
+    std::vector<SeedResult> best;
+    best.reserve(topK + 1);
+    std::deque<TFuture<GeneratedLevel>> inFlight;
+
+    const size_t maxInFlight = static_cast<size_t>(batch.GetWorkerCount()) * c_JobsPerWorker;
+    const int64 endSeed = static_cast<int64>(firstSeed) + seedCount;
+    int64 nextSeed = firstSeed;
+
+    int64 completed = 0;
+    int64 failed = 0;
+    int64 duplicates = 0;
+
+    const double start = FPlatformTime::Seconds();
+    double lastProgress = start;
+
+    while (nextSeed < endSeed || !inFlight.empty())
+    {
+        while (nextSeed < endSeed && inFlight.size() < maxInFlight)
+        {
+            options.Level = static_cast<int32>(nextSeed++);
+            inFlight.push_back(batch.GenerateLevel(options));
+        }
+
+        GeneratedLevel generated = inFlight.front().Get();
+        inFlight.pop_front();
+
+        completed++;
+
+        if (!generated.Success)
+        {
+            failed++;
+            continue;
+        }
+
+        SeedResult result;
+        result.Seed = generated.Options.Level;
+        result.Fingerprint = generated.Fingerprint;
+        result.Values.reserve(metrics.size());
+
+        for (const auto& weighted : metrics)
+        {
+            float value = weighted.Metric->Measure(generated);
+            result.Values.push_back(value);
+            result.Score += value * weighted.Weight;
+        }
+
+        const bool keep = (best.size() < static_cast<size_t>(topK)) || SeedResultCompare()(result, best.front());
+
+        // Different seeds can produce the same level, and a list full of the same level isn't useful
+        if (keep && std::any_of(best.begin(), best.end(), [&result](const SeedResult& kept) { return kept.Fingerprint == result.Fingerprint; }))
+        {
+            duplicates++;
+        }
+        else if (keep)
+        {
+            best.push_back(std::move(result));
+            std::push_heap(best.begin(), best.end(), SeedResultCompare());
+
+            if (best.size() > static_cast<size_t>(topK))
+            {
+                std::pop_heap(best.begin(), best.end(), SeedResultCompare());
+                best.pop_back();
+            }
+        }
+
+        const double now = FPlatformTime::Seconds();
+        if ((now - lastProgress) >= c_ProgressSeconds)
+        {
+            UE_LOG(HoloPipesLog, Display, L"SeedSearch - %lld / %d seeds, %.1f seeds/sec", completed, seedCount, completed / (now - start));
+            lastProgress = now;
+        }
+    }
+
+    const double seconds = FPlatformTime::Seconds() - start;
+
+    UE_LOG(HoloPipesLog, Display, L"SeedSearch - Searched %lld seeds (%lld failed, %lld duplicate levels) in %.2f seconds, %.1f seeds/sec",
+        completed, failed, duplicates, seconds, (seconds > 0.0) ? (completed / seconds) : 0.0);
+
+    // Sorting the heap leaves the best result first
+    std::vector<SeedResult> ranked = std::move(best);
+    std::sort_heap(ranked.begin(), ranked.end(), SeedResultCompare());
+
+    FString csv = L"Rank,Seed,Score,Fingerprint";
+    for (const auto& weighted : metrics)
+    {
+        csv += FString::Printf(L",%s", weighted.Metric->GetName());
+    }
+    csv += L"\n";
+
+    for (size_t rank = 0; rank < ranked.size(); rank++)
+    {
+        const SeedResult& result = ranked[rank];
+
+        FString values;
+        FString csvValues;
+        for (size_t i = 0; i < metrics.size(); i++)
+        {
+            values += FString::Printf(L" %s %g", metrics[i].Metric->GetName(), result.Values[i]);
+            csvValues += FString::Printf(L",%g", result.Values[i]);
+        }
+
+        UE_LOG(HoloPipesLog, Display, L"SeedSearch - #%d: seed %d, score %g (%s )", (int32)rank + 1, result.Seed, result.Score, *values);
+        csv += FString::Printf(L"%d,%d,%g,%s%s\n", (int32)rank + 1, result.Seed, result.Score, *result.Fingerprint.ToString(), *csvValues);
+    }
+
+    if (!outputPath.IsEmpty() && !FFileHelper::SaveStringToFile(csv, *outputPath))
+    {
+        UE_LOG(HoloPipesLog, Error, L"SeedSearch - Unable to write %s", *outputPath);
+        return 1;
+    }
+
+    return 0;
+}
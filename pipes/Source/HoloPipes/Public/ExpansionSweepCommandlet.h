@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "ExpansionSweepCommandlet.generated.h"
+
+/**
+ * Measures how routing scales with the play space. Generates one level with the game's rules for Level
+ * at each play space size in Sides, once routed through chunks and once over the whole grid (see
+ * LevelGenerator::SetHierarchicalRouting), and logs the nodes expanded (LevelGenerator::GetLastExpansionCount)
+ * and time taken by each side by side, along with how the expansions grew from one size to the next.
+ * Play spaces below 12 are never routed through chunks, so both columns match there.
+ *
+ *   UE4Editor-Cmd.exe HoloPipes -run=ExpansionSweep [-Sides=16,32,64] [-Level=400] [-BeamWidth=0]
+ *                     [-MemoryBudgetKB=0]
+ *
+ * Returns non-zero if any size fails to generate
+ */
+UCLASS()
+class HOLOPIPES_API UExpansionSweepCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    UExpansionSweepCommandlet();
+
+    virtual int32 Main(const FString& params) override;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "GeneratorJitterCommandlet.generated.h"
+
+/**
+ * Measures how much background level generation disturbs a frame loop, to tune the generator's
+ * scheduling policy (FGenerateOptions::ThreadPriority, AffinityMask and YieldEveryExpansions).
+ *
+ * A synthetic frame does a fixed amount of work (calibrated to WorkMs when running alone) and then waits
+ * out the rest of FrameMs. The loop runs once on its own and once while the generator produces levels
+ * back to back, and both runs report their work time percentiles and missed frames.
+ *
+ *   UE4Editor-Cmd.exe HoloPipes -run=GeneratorJitter [-Frames=600] [-FrameMs=16.67] [-WorkMs=8]
+ *                     [-Level=200] [-Priority=Normal|BelowNormal|Lowest] [-Affinity=0] [-YieldEvery=0]
+ *                     [-FrameAffinity=0]
+ */
+UCLASS()
+class HOLOPIPES_API UGeneratorJitterCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    UGeneratorJitterCommandlet();
+
+    virtual int32 Main(const FString& params) override;
+};
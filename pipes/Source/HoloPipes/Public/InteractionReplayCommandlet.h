@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "InteractionReplayCommandlet.generated.h"
+
+/**
+ * Plays back input recorded with APPipesGameMode::StartInputRecording against a grid in a world of
+ * its own, with nothing rendered, and reports what each frame spent on gaze, focus, drag, rotate,
+ * cursor and resolve (see APPipeGrid::ReplayInput). Run headless with:
+ *
+ *   UE4Editor-Cmd.exe HoloPipes -run=InteractionReplay -File=Path -Grid=/Game/Path/To/Grid.Grid_C
+ *                     [-Csv=Path] [-Repeat=1] -nullrhi
+ *
+ * The grid class is the game mode's PipeGridClass, so the replay spawns the same pipes the game does.
+ * Each repeat rebuilds the level and replays the whole recording. Returns non-zero if it can't replay
+ */
+UCLASS()
+class HOLOPIPES_API UInteractionReplayCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    UInteractionReplayCommandlet();
+
+    virtual int32 Main(const FString& params) override;
+};
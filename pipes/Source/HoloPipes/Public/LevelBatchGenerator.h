@@ -0,0 +1,98 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include <vector>
+#include <deque>
+#include <memory>
+#include <Containers/ArrayView.h>
+#include <Async/Future.h>
+#include <HAL/Runnable.h>
+#include <HAL/RunnableThread.h>
+#include "LevelGenerator.h"
+
+// The result of a single level generated by LevelBatchGenerator
+struct GeneratedLevel
+{
+    FGenerateOptions Options = {};
+    bool Success = false;
+
+    std::vector<PipeSegmentGenerated> VirtualPipes;
+    std::vector<PipeSegmentGenerated> RealizedPipes;
+
+    LevelFingerprint Fingerprint;
+    int32 ParScore = 0;
+    bool ParScoreExact = false;
+    int64 ExpansionCount = 0;
+    double GenerateSeconds = 0.0;
+};
+
+//
+// Generates many levels at once for tools (level pack baking, seed searches, regression runs).
+// Each worker thread owns its own LevelGenerator and reuses it job after job. The generator's segment
+// grid and candidate lists keep their capacity between levels, so a worker only allocates them again
+// when a job needs a bigger play space than any it has run.
+//
+// Concurrency is bounded by the number of workers, and memory by admitting a job only when its
+// estimated footprint (LevelGenerator::EstimateMemoryKB) fits in what the running jobs leave of
+// the budget. Jobs are started in the order they were queued.
+//
+class HOLOPIPES_API LevelBatchGenerator
+{
+public:
+
+    // maxWorkers of 0 uses one worker per core. memoryBudgetKB of 0 leaves memory unbounded; otherwise
+    // any job that couldn't fit on its own gets its FGenerateOptions::MemoryBudgetKB capped to the budget
+    LevelBatchGenerator(int32 maxWorkers = 0, int32 memoryBudgetKB = 0);
+    ~LevelBatchGenerator();
+
+    LevelBatchGenerator(const LevelBatchGenerator&) = delete;
+    LevelBatchGenerator& operator=(const LevelBatchGenerator&) = delete;
+
+    TFuture<GeneratedLevel> GenerateLevel(const FGenerateOptions& options);
+    std::vector<TFuture<GeneratedLevel>> GenerateLevels(TArrayView<const FGenerateOptions> options);
+
+    // Fails every job that hasn't started yet. Jobs already running are left to finish
+    void CancelPending();
+
+    int32 GetWorkerCount() const { return static_cast<int32>(m_workers.size()); }
+    int32 GetPendingCount();
+
+private:
+
+    struct Job
+    {
+        FGenerateOptions Options;
+        uint64 MemoryKB;
+        TPromise<GeneratedLevel> Promise;
+    };
+
+    // One thread of the pool, with the generator it reuses for every job it runs
+    class Worker : public FRunnable
+    {
+    public:
+
+        explicit Worker(LevelBatchGenerator& batch) : m_batch(batch) {}
+
+        virtual uint32 Run() override;
+
+        LevelBatchGenerator& m_batch;
+        LevelGenerator m_generator;
+        FRunnableThread* m_thread = nullptr;
+    };
+
+    TFuture<GeneratedLevel> QueueJob(const FGenerateOptions& options);
+    void RunWorker(LevelGenerator& generator);
+    bool CanStartNextJob();
+
+    std::vector<std::unique_ptr<Worker>> m_workers;
+
+    // Guards everything below. m_jobsChanged wakes one waiting worker at a time; a worker that's woken
+    // passes the wake on when there's more for the others to do (or we're shutting down)
+    FCriticalSection m_lock;
+    FEvent* m_jobsChanged = nullptr;
+    std::deque<Job> m_jobs;
+
+    uint64 m_memoryBudgetKB = 0;
+    uint64 m_memoryInUseKB = 0;
+    bool m_shutdown = false;
+};
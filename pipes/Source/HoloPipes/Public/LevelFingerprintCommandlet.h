@@ -0,0 +1,30 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LevelFingerprintCommandlet.generated.h"
+
+/**
+ * Regression check for the level generator. Generates levels FirstLevel..LastLevel with the game's rules
+ * and either writes their fingerprints (see LevelFingerprint) to a golden table, or verifies them against
+ * one. A generator change that is meant to be an optimization should verify cleanly.
+ *
+ *   UE4Editor-Cmd.exe HoloPipes -run=LevelFingerprint -Write [-File=Path] [-FirstLevel=1] [-LastLevel=1000]
+ *   UE4Editor-Cmd.exe HoloPipes -run=LevelFingerprint -Verify [-File=Path] [-Workers=0]
+ *
+ * The table defaults to Build/LevelFingerprints.csv in the project directory. It's only meaningful if it
+ * was written by this commandlet, in the engine, from a generator known to be right, and it should be
+ * checked in covering levels 1..1000. Rewrite it only when a change is meant to produce different levels.
+ * Returns non-zero if any level fails to verify
+ */
+UCLASS()
+class HOLOPIPES_API ULevelFingerprintCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    ULevelFingerprintCommandlet();
+
+    virtual int32 Main(const FString& params) override;
+};
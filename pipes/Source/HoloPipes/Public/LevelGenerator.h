@@ -1,232 +1,484 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include <random>
-#include <list>
-#include <vector>
-#include <set>
-#include <algorithm>
-#include <HAL/Runnable.h>
-#include <HAL/RunnableThread.h>
-#include <UObject/ObjectMacros.h>
-#include <atomic>
-#include "PPipe.h"
-#include "LevelGenerator.generated.h"
-
-class RNG
-{
-public:
-
-	void Init(int seed)
-	{
-		int seedSeqSeed[] = { seed, ' ', 'L', 'e', 'v', 'e', 'l', ' ', seed + 1, ' ', 's', 'e', 'e', 'd', ' ', seed + 2 };
-		std::seed_seq seedSeq(seedSeqSeed, seedSeqSeed + ARRAYSIZE(seedSeqSeed));
-		engine.seed(seedSeq);
-
-		// While not strictly necessary, burning through a quick 100 random numbers helps us get to a "more
-		// random" sequence of numbers when using mod (the lower bits have more randomess when the engine is
-		// "warmed up"
-		//
-		// Experts disagree on whether this is true, but it's cheap to generate a few numbers and throw them away
-		for (int i = 0; i < 100; i++)
-		{
-			GetInt();
-		}
-	}
-
-	float GetFloat()
-	{
-		return (double)engine() / (double)engine.max();
-	}
-
-	UINT32 GetInt()
-	{
-		return engine();
-	}
-
-	UINT32 GetInt(UINT32 minInclusive, UINT32 maxExclusive)
-	{
-		if (maxExclusive <= (minInclusive + 1))
-		{
-			return minInclusive;
-		}
-
-		return (engine() % (maxExclusive - minInclusive)) + minInclusive;
-	}
-
-	bool GetBool()
-	{
-		return GetInt(0, 1) == 1;
-	}
-
-	template <class t>
-	void Shuffle(std::vector<t>& v)
-	{
-		std::shuffle(v.begin(), v.end(), engine);
-	}
-
-
-private:
-
-	std::mt19937 engine;
-};
-
-enum class GeneratorStatus
-{
-	Idle,		// The generator hasn't been started
-	Generating,	// The generetor is actively generating the last requested level
-	Canceling,	// The generator has been asked to stop prematurely
-	Failed,		// The generator has finished, but failed to complete a level
-	Complete	// The generator has finished a complete level
-};
-
-USTRUCT(BlueprintType)
-struct FGenerateOptions
-{
-	GENERATED_BODY()
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	int32 Level;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	int32 PlaySpaceSize;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	int32 MaxNumPipes;
-
-	UPROPERTY(EditAnywhere, BlueprintReadWrite)
-	int32 MaxJunctions;
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite)
-    int32 MaxFixed;
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite)
-    int32 MaxBlocks;
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite)
-    float StraightCost;
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite)
-    float CornerCost;
-};
-
-/**
- * 
- */
-class HOLOPIPES_API LevelGenerator : FRunnable
-{
-public:
-
-	LevelGenerator();
-	virtual ~LevelGenerator();
-
-	bool GenerateLevel(const FGenerateOptions& options);
-	void CancelLevel();
-
-	GeneratorStatus GetStatus() { return m_status.load(); }
-
-	std::vector<PipeSegmentGenerated> VirtualPipes;
-	std::vector<PipeSegmentGenerated> RealizedPipes;
-		
-private:
-
-	//
-	// FRunnable
-	//
-
-	virtual uint32 Run() override;
-
-    struct PipeTemp
-    {
-        int Class;
-        int Junctions;
-        int Fixed;
-    };
-
-    enum BuildState
-    {
-        None,
-        OpenList,
-        ClosedList,
-        Committing,
-        Committed
-    };
-
-	struct PipeSegmentTemp : public PipeSegmentGenerated
-	{
-		const static PipeSegmentTemp c_Empty;
-
-		bool Fixed = false;
-        BuildState State = BuildState::None;
-
-        FPipeGridCoordinate ParentLocation = FPipeGridCoordinate::Zero;
-        PipeDirections ParentDirection = PipeDirections::None;
-
-        int PathCost = 0;
-        int PredictedCost = 0;
-
-        int TotalCost() const { return PathCost + PredictedCost; }
-	};
-
-	void SetStatus(GeneratorStatus status) { m_status.store(status); }
-
-    int ComputePredictedCost(const FPipeGridCoordinate& from, const FPipeGridCoordinate& to, PipeDirections parentToChild, PipeDirections endSide);
-
-	PipeSegmentTemp& GetSegment(const FPipeGridCoordinate& location);
-	PipeSegmentTemp& GetSegment(int x, int y, int z);
-
-	void Reset(bool resetThread, bool resetVirtualAndRealizedLists);
-    bool FinalizeLevel();
-
-    PipeDirections SideFromCoordinate(const FPipeGridCoordinate& coordinate);
-    void BuildStartCandidateList(PipeDirections side);
-    void BuildEndCandidateList(PipeDirections half);
-    
-    bool GenerateBlocks(int count);
-	bool GeneratePipe(const PipeTemp& pipe);
-    bool GeneratePipe(const PipeTemp& pipe, const FPipeGridCoordinate& startCoordinate, PipeDirections startDirection);
-    bool GenerateJunctions(const PipeTemp& pipe);
-    bool GenerateJunction(const PipeTemp& pipe);
-    bool GenerateFixed(const PipeTemp& pipe);
-
-    bool CompletePipe(const PipeTemp& pipe, const FPipeGridCoordinate& endCoordinate, bool forJunction);
-
-    bool CommitPipe(const PipeTemp& pipe, const FPipeGridCoordinate& end);
-    void ResetAStar();
-    void RemoveFromOpen(PipeSegmentTemp* victim);
-    PipeSegmentTemp* RemoveRandomLeastFromOpen();
-
-    std::vector<PipeTemp> m_pipesToBuild;
-    std::vector<PipeSegmentTemp> m_pipeGrid;
-
-    struct PipeSegmentTempCompare
-    {
-        bool operator() (const PipeSegmentTemp* lhs, const PipeSegmentTemp* rhs) const
-        {
-            return ((lhs->TotalCost()) < (rhs->TotalCost()));
-        }
-    };
-    std::multiset<PipeSegmentTemp*, PipeSegmentTempCompare> m_openList;
-    std::vector<PipeSegmentTemp*> m_closedList;
-    std::vector<PipeSegmentTemp*> m_committingList;
-
-	RNG m_rng;
-
-    int m_sideMin = 0;
-    int m_sideMax = 0;
-    int m_playSpaceSize = 0;
-	int m_gridSide = 0; 
-	int m_gridSideSquared = 0;
-	int m_gridSideCubed = 0;
-    int m_straightCost = 0;
-    int m_cornerCost = 0;
-    std::vector<FPipeGridCoordinate> m_startCandidates;
-    std::vector<FPipeGridCoordinate> m_endCandidates;
-
-	std::atomic<GeneratorStatus> m_status;
-	volatile bool m_abortExecution = false;
-
-	FRunnableThread* m_thread = nullptr;
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include <random>
+#include <list>
+#include <vector>
+#include <set>
+#include <algorithm>
+#include <HAL/Runnable.h>
+#include <HAL/RunnableThread.h>
+#include <UObject/ObjectMacros.h>
+#include <atomic>
+#include <Containers/Queue.h>
+#include "PPipe.h"
+#include "LevelGenerator.generated.h"
+
+class RNG
+{
+public:
+
+	void Init(int seed)
+	{
+		int seedSeqSeed[] = { seed, ' ', 'L', 'e', 'v', 'e', 'l', ' ', seed + 1, ' ', 's', 'e', 'e', 'd', ' ', seed + 2 };
+		std::seed_seq seedSeq(seedSeqSeed, seedSeqSeed + ARRAYSIZE(seedSeqSeed));
+		engine.seed(seedSeq);
+
+		// While not strictly necessary, burning through a quick 100 random numbers helps us get to a "more
+		// random" sequence of numbers when using mod (the lower bits have more randomess when the engine is
+		// "warmed up"
+		//
+		// Experts disagree on whether this is true, but it's cheap to generate a few numbers and throw them away
+		for (int i = 0; i < 100; i++)
+		{
+			GetInt();
+		}
+	}
+
+	// Seeds from a pair of values, so (a, b) and (b, a) give different sequences
+	void Init(int seed, int subSeed)
+	{
+		int seedSeqSeed[] = { seed, ' ', 'M', 'u', 't', 'a', 't', 'e', subSeed, ' ', seed + 1, subSeed + 1 };
+		std::seed_seq seedSeq(seedSeqSeed, seedSeqSeed + ARRAYSIZE(seedSeqSeed));
+		engine.seed(seedSeq);
+
+		for (int i = 0; i < 100; i++)
+		{
+			GetInt();
+		}
+	}
+
+	float GetFloat()
+	{
+		return (double)engine() / (double)engine.max();
+	}
+
+	UINT32 GetInt()
+	{
+		return engine();
+	}
+
+	UINT32 GetInt(UINT32 minInclusive, UINT32 maxExclusive)
+	{
+		if (maxExclusive <= (minInclusive + 1))
+		{
+			return minInclusive;
+		}
+
+		return (engine() % (maxExclusive - minInclusive)) + minInclusive;
+	}
+
+	bool GetBool()
+	{
+		return GetInt(0, 1) == 1;
+	}
+
+	// Fisher-Yates, drawing each index the way the MSVC library's std::shuffle does, so levels match the
+	// ones shipped builds have always generated. std::shuffle itself is free to draw differently on other
+	// standard libraries, and a level has to be the same level wherever it's generated
+	template <class t>
+	void Shuffle(std::vector<t>& v)
+	{
+		for (size_t target = 1; target < v.size(); target++)
+		{
+			const size_t swapWith = GetIndex(target + 1);
+			if (swapWith != target)
+			{
+				std::swap(v[target], v[swapWith]);
+			}
+		}
+	}
+
+
+private:
+
+	// A uniform index below count, rejecting the draws that would favor the low indexes
+	size_t GetIndex(size_t count)
+	{
+		const uint64 mask = 0xffffffffull;
+
+		while (true)
+		{
+			const uint64 value = engine();
+			if ((value / count) < (mask / count) || (mask % count) == (count - 1))
+			{
+				return static_cast<size_t>(value % count);
+			}
+		}
+	}
+
+	std::mt19937 engine;
+};
+
+enum class GeneratorStatus
+{
+	Idle,		// The generator hasn't been started
+	Generating,	// The generetor is actively generating the last requested level
+	Canceling,	// The generator has been asked to stop prematurely
+	Failed,		// The generator has finished, but failed to complete a level
+	Complete	// The generator has finished a complete level
+};
+
+// Priority of the generator thread (see FGenerateOptions::ThreadPriority)
+UENUM(BlueprintType)
+enum class EGeneratorPriority : uint8
+{
+    Normal,
+    BelowNormal,
+    Lowest
+};
+
+USTRUCT(BlueprintType)
+struct FGenerateOptions
+{
+	GENERATED_BODY()
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 Level;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 PlaySpaceSize;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxNumPipes;
+
+	UPROPERTY(EditAnywhere, BlueprintReadWrite)
+	int32 MaxJunctions;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 MaxFixed;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 MaxBlocks;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float StraightCost;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float CornerCost;
+
+    // When greater than 0, routing keeps at most this many nodes on the open list (beam search),
+    // dropping the most expensive ones. Full A* is only used if the beam finds nothing
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 BeamWidth;
+
+    // When greater than 0, the generator sizes all of its buffers to fit in this many KB, narrowing
+    // the beam (and skipping the full A* fallback) if an unbounded open list wouldn't fit
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 MemoryBudgetKB;
+
+    // Time the level solver may spend proving the par score, in milliseconds. When it runs out
+    // (or this is 0), GetParScoreExact is false and callers should use their own heuristic
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float SolverBudgetMs;
+
+    // When true, each pipe is published (see LevelGenerator::DequeueStreamedPipes) as soon as it and
+    // its junctions and fixed pieces are done, so callers can start spawning it while later pipes
+    // are still being routed. VirtualPipes and RealizedPipes are filled in exactly as without streaming
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    bool StreamPipes;
+
+    // When not 0, the level is derived from the level these options describe without a mutation (the
+    // parent) by ripping up some of its pipes and routing them again. The result only depends on the
+    // parent's options and MutationSeed. The parent is kept between calls, so mutating the same parent
+    // again is much cheaper than generating a new level. Streaming is ignored when mutating
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 MutationSeed;
+
+    // Fraction (0 to 1) of the pipes, and of the blocks, to rip up when mutating. At least one pipe is
+    // always ripped up
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    float MutationFraction;
+
+    //
+    // Scheduling. These only apply to the thread GenerateLevel creates (GenerateLevelSync ignores them),
+    // and a level generates identically under any policy
+    //
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    EGeneratorPriority ThreadPriority;
+
+    // Cores the generator thread may run on, one bit per core (0 for any core)
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int64 AffinityMask;
+
+    // When greater than 0, routing gives up the rest of its time slice every this many expansions, so a
+    // thread sharing the core (such as the render thread) isn't starved
+    UPROPERTY(EditAnywhere, BlueprintReadWrite)
+    int32 YieldEveryExpansions;
+};
+
+// A 128 bit hash of a level's pipes that doesn't depend on the order they're listed in, so two levels
+// with the same fingerprint are (barring a collision) the same level
+struct LevelFingerprint
+{
+    uint64 Low = 0;
+    uint64 High = 0;
+
+    bool operator==(const LevelFingerprint& other) const { return Low == other.Low && High == other.High; }
+    bool operator!=(const LevelFingerprint& other) const { return !(*this == other); }
+
+    FString ToString() const { return FString::Printf(L"%016llx%016llx", High, Low); }
+
+    // Adds one pipe. Each pipe is hashed on its own and the hashes are summed, which is what makes
+    // the result independent of order
+    void Add(const PipeSegmentGenerated& segment, bool fixed);
+
+    static LevelFingerprint Compute(const std::vector<PipeSegmentGenerated>& realized, const std::vector<PipeSegmentGenerated>& placeable);
+};
+
+/**
+ * 
+ */
+class HOLOPIPES_API LevelGenerator : FRunnable
+{
+public:
+
+	LevelGenerator();
+	virtual ~LevelGenerator();
+
+	bool GenerateLevel(const FGenerateOptions& options);
+	void CancelLevel();
+
+    // Generates the level on the calling thread, returning once it is Complete or Failed. The segment grid
+    // and candidate lists keep their capacity between calls, so reuse one generator for many levels
+    bool GenerateLevelSync(const FGenerateOptions& options);
+
+    // Roughly how much memory generating a level with these options can take, in KB. This is the memory
+    // budget when one is set, and the cost of an unbounded open list otherwise
+    static uint64 EstimateMemoryKB(const FGenerateOptions& options);
+
+	GeneratorStatus GetStatus() { return m_status.load(); }
+
+    // Number of nodes pulled off the open list while generating the last level. Useful for
+    // comparing the cost of routing strategies across play space sizes
+    int64 GetLastExpansionCount() { return m_lastExpansionCount.load(); }
+
+    // Large play spaces are routed through a corridor of chunks unless this is turned off, which makes
+    // every search run over the whole grid. For tools that compare the two; a level routed without the
+    // corridor can differ from the one the game makes. Only call this while the generator is idle
+    void SetHierarchicalRouting(bool enabled);
+
+    // The fewest grasps needed to solve the last generated level (see LevelSolver). Only meaningful
+    // once the generator is Complete, and only trustworthy if GetParScoreExact is true
+    int32 GetParScore() { return m_parScore; }
+    bool GetParScoreExact() { return m_parScoreExact; }
+    double GetLastSolveSeconds() { return m_lastSolveSeconds; }
+
+    // Fingerprint of VirtualPipes and RealizedPipes, built as FinalizeLevel fills them in
+    LevelFingerprint GetFingerprint() { return m_fingerprint; }
+
+    // A finished part of the level: the blocks, or one pipe class with its junctions and fixed pieces.
+    // Together, the streamed pipes of a level hold exactly the segments of RealizedPipes and VirtualPipes
+    struct StreamedPipes
+    {
+        std::vector<PipeSegmentGenerated> Realized;
+        std::vector<PipeSegmentGenerated> Virtual;
+    };
+
+    // Only generates anything when FGenerateOptions::StreamPipes was set. The queue is single consumer,
+    // so this should only be called from the thread that called GenerateLevel
+    bool DequeueStreamedPipes(StreamedPipes& pipes) { return m_streamQueue.Dequeue(pipes); }
+
+	std::vector<PipeSegmentGenerated> VirtualPipes;
+	std::vector<PipeSegmentGenerated> RealizedPipes;
+		
+private:
+
+	//
+	// FRunnable
+	//
+
+	virtual uint32 Run() override;
+
+    // GenerateLevel and GenerateLevelSync both Prepare on the calling thread. Execute does the rest,
+    // either on the generator thread or the calling thread
+    bool Prepare(const FGenerateOptions& options);
+    bool Execute();
+
+    struct PipeTemp
+    {
+        int Class;
+        int Junctions;
+        int Fixed;
+    };
+
+    enum BuildState
+    {
+        None,
+        OpenList,
+        ClosedList,
+        Committing,
+        Committed
+    };
+
+	struct PipeSegmentTemp : public PipeSegmentGenerated
+	{
+		const static PipeSegmentTemp c_Empty;
+
+		bool Fixed = false;
+        BuildState State = BuildState::None;
+
+        FPipeGridCoordinate ParentLocation = FPipeGridCoordinate::Zero;
+        PipeDirections ParentDirection = PipeDirections::None;
+
+        int PathCost = 0;
+        int PredictedCost = 0;
+
+        int TotalCost() const { return PathCost + PredictedCost; }
+	};
+
+	void SetStatus(GeneratorStatus status) { m_status.store(status); }
+
+    int ComputePredictedCost(const FPipeGridCoordinate& from, const FPipeGridCoordinate& to, PipeDirections parentToChild, PipeDirections endSide);
+
+	PipeSegmentTemp& GetSegment(const FPipeGridCoordinate& location);
+	PipeSegmentTemp& GetSegment(int x, int y, int z);
+
+	void Reset(bool resetThread, bool resetVirtualAndRealizedLists);
+    bool FinalizeLevel();
+
+    PipeDirections SideFromCoordinate(const FPipeGridCoordinate& coordinate);
+    void BuildStartCandidateList(PipeDirections side);
+    void BuildEndCandidateList(PipeDirections half);
+    
+    bool GenerateBlocks(int count);
+	bool GeneratePipe(const PipeTemp& pipe);
+    bool GeneratePipe(const PipeTemp& pipe, const FPipeGridCoordinate& startCoordinate, PipeDirections startDirection);
+    bool GenerateJunctions(const PipeTemp& pipe);
+    bool GenerateJunction(const PipeTemp& pipe);
+    bool GenerateFixed(const PipeTemp& pipe);
+
+    // Mutation
+    static bool SameParent(const FGenerateOptions& lhs, const FGenerateOptions& rhs);
+    void SaveParent();
+    void LoadParent();
+    bool Mutate();
+
+    static uint64 FixedBytesFor(int playSpaceSize);
+    bool ApplyMemoryBudget(const FGenerateOptions& options);
+    void PublishStreamedPipes();
+
+    bool CompletePipe(const PipeTemp& pipe, const FPipeGridCoordinate& endCoordinate, bool forJunction);
+    bool SearchPipe(const PipeTemp& pipe, const FPipeGridCoordinate& endCoordinate, bool forJunction);
+    void TrimOpenList();
+
+    bool CommitPipe(const PipeTemp& pipe, const FPipeGridCoordinate& end);
+    void ResetAStar();
+    void RemoveFromOpen(PipeSegmentTemp* victim);
+    PipeSegmentTemp* RemoveRandomLeastFromOpen();
+
+    std::vector<PipeTemp> m_pipesToBuild;
+    std::vector<PipeSegmentTemp> m_pipeGrid;
+
+    struct PipeSegmentTempCompare
+    {
+        bool operator() (const PipeSegmentTemp* lhs, const PipeSegmentTemp* rhs) const
+        {
+            return ((lhs->TotalCost()) < (rhs->TotalCost()));
+        }
+    };
+    std::multiset<PipeSegmentTemp*, PipeSegmentTempCompare> m_openList;
+    std::vector<PipeSegmentTemp*> m_closedList;
+    std::vector<PipeSegmentTemp*> m_committingList;
+    std::vector<PipeSegmentTemp*> m_fixedCandidates;
+
+	RNG m_rng;
+
+    int m_sideMin = 0;
+    int m_sideMax = 0;
+    int m_playSpaceSize = 0;
+	int m_gridSide = 0; 
+	int m_gridSideSquared = 0;
+	int m_gridSideCubed = 0;
+    int m_straightCost = 0;
+    int m_cornerCost = 0;
+    std::vector<FPipeGridCoordinate> m_startCandidates;
+    std::vector<FPipeGridCoordinate> m_endCandidates;
+
+    // Beam search / memory budget. c_OpenListNodeBytes is our estimate of a single open list entry
+    // (the pointer plus the multiset's node overhead)
+    static constexpr size_t c_OpenListNodeBytes = 48;
+
+    size_t m_beamWidth = 0;
+    bool m_beamActive = false;
+    bool m_beamTruncated = false;
+    bool m_allowFullSearch = true;
+
+    //
+    // Hierarchical routing (large play spaces only)
+    //
+    // The grid is split into cubic chunks. For each chunk we cache which of its six faces has at least
+    // one open crossing into the neighboring chunk (a "portal"). Before running A* we find a coarse
+    // corridor of chunks between the open list and the end, and only let A* expand inside that corridor.
+    // If the corridor doesn't contain a path, we fall back to searching the full grid.
+    //
+
+    static constexpr int c_ChunkSide = 8;
+    static constexpr int c_HierarchicalMinPlaySpace = 12;
+
+    struct ChunkPortals
+    {
+        bool Dirty = true;
+        PipeDirections OpenFaces = PipeDirections::None;
+    };
+
+    void InitializeChunks();
+    int ChunkIndexOf(const FPipeGridCoordinate& location);
+    FPipeGridCoordinate ChunkCoordinateOf(int chunkIndex);
+    void InvalidateChunksAround(const FPipeGridCoordinate& location);
+    void UpdateChunkPortals(int chunkIndex);
+    bool IsOpenForRouting(const FPipeGridCoordinate& location);
+    bool BuildCorridor(const FPipeGridCoordinate& endCoordinate);
+    bool InCorridor(const FPipeGridCoordinate& location);
+
+    void SaveSearchSeeds();
+    void RestoreSearchSeeds();
+
+    bool m_hierarchicalEnabled = true;
+    bool m_hierarchical = false;
+    bool m_corridorActive = false;
+    int m_chunksPerSide = 0;
+    int m_chunksPerSideSquared = 0;
+    int m_corridorStamp = 0;
+    std::vector<ChunkPortals> m_chunks;
+    std::vector<int> m_chunkCorridorStamps;
+    std::vector<int> m_chunkParents;
+    std::vector<int> m_chunkSearch;
+    std::vector<PipeSegmentTemp> m_searchSeedCopies;
+    std::vector<PipeSegmentTemp*> m_searchSeedSegments;
+
+    // Streaming. Segments are added to m_streamPending as they are committed, and published once
+    // nothing else can change them (junctions and fixed pieces edit already committed segments)
+    bool m_streamPipes = false;
+    size_t m_streamedSegmentCount = 0;
+    std::vector<PipeSegmentTemp*> m_streamPending;
+    TQueue<StreamedPipes, EQueueMode::Spsc> m_streamQueue;
+
+    LevelFingerprint m_fingerprint;
+
+    // The options of the level being generated, and the last level generated without a mutation. The
+    // parent's pipes survive Reset so they can be mutated again
+    FGenerateOptions m_options = {};
+    FGenerateOptions m_parentOptions = {};
+    bool m_haveParent = false;
+    bool m_parentLoaded = false;
+    std::vector<PipeSegmentGenerated> m_parentRealized;
+    std::vector<PipeSegmentGenerated> m_parentVirtual;
+
+    float m_solverBudgetMs = 0.0f;
+    int32 m_parScore = 0;
+    bool m_parScoreExact = false;
+    double m_lastSolveSeconds = 0.0;
+
+    int64 m_expansionCount = 0;
+    int64 m_yieldEveryExpansions = 0;
+    std::atomic<int64> m_lastExpansionCount{ 0 };
+
+	std::atomic<GeneratorStatus> m_status;
+	volatile bool m_abortExecution = false;
+
+	FRunnableThread* m_thread = nullptr;
+};
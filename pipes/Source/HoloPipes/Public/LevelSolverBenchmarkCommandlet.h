@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "LevelSolverBenchmarkCommandlet.generated.h"
+
+/**
+ * Generates levels 1 through LastLevel with the game's rules and logs how long the level solver took
+ * on each and how many par scores it proved (see FGenerateOptions::SolverBudgetMs).
+ *
+ *   UE4Editor-Cmd.exe HoloPipes -run=LevelSolverBenchmark [-LastLevel=100]
+ *                     [-GameMode=/Game/Path/To/GameMode.GameMode_C]
+ *
+ * Returns non-zero if any level fails to generate
+ */
+UCLASS()
+class HOLOPIPES_API ULevelSolverBenchmarkCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    ULevelSolverBenchmarkCommandlet();
+
+    virtual int32 Main(const FString& params) override;
+};
@@ -1,336 +1,643 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/Actor.h"
-#include "PPipe.h"
-#include "PMRPawn.h"
-#include "PToolbox.h"
-#include <unordered_map>
-#include <functional>
-#include "PPipeGrid_PlaceWorld.h"
-#include "PPipeGrid_GridHands.h"
-#include "PPipeGrid_Cursor.h"
-#include "PPipeGrid_Interaction.h"
-#include "PPipeGrid_Score.h"
-#include "PPipeGrid.generated.h"
-
-DECLARE_DYNAMIC_MULTICAST_DELEGATE(FGridSolved);
-DECLARE_DYNAMIC_MULTICAST_DELEGATE(FGridUpdated);
-DECLARE_DYNAMIC_MULTICAST_DELEGATE(FToolboxMoved);
-
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FPipeGrasped, FPipeGridCoordinate, graspLocation);
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FPipeDropped, FPipeGridCoordinate, dropLocation);
-DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FRotateHandleShown, FPipeGridCoordinate, pipeLocation, EInteractionAxis, axis);
-
-enum class AddPipeOptions
-{
-    None                = 0x00,
-    InToolbox           = 0x01, // For internal use only
-    Fixed               = 0x02,
-    FromToolbox         = 0x04
-}; 
-
-DEFINE_ENUM_FLAG_OPERATORS(AddPipeOptions);
-
-struct GridPipe
-{
-    APPipe* pipe;
-    FPipeGridCoordinate currentLocation;
-    int currentPipeClass;
-};
-
-UCLASS()
-class HOLOPIPES_API APPipeGrid : public AActor
-{
-	GENERATED_BODY()
-	
-public:
-
-	// Sets default values for this actor's properties
-	APPipeGrid();
-
-    UFUNCTION(BlueprintCallable)
-	void Clear();
-
-    void SetPawn(APMRPawn* pawn);
-
-    void InitializeToolbox(const std::vector<PipeSegmentGenerated>& pipesInToolbox, int playableGridSize);
-    void AddToToolbox(const std::vector<PipeSegmentGenerated>& pipesInToolbox);
-    void RemoveToolbox();
-
-    void AddPipes(const std::vector<PipeSegmentGenerated>& pipes, AddPipeOptions options);
-	void AddPipe(const PipeSegmentGenerated& pipeToAdd, AddPipeOptions options);
-
-    void GetPipeInfo(FPipeGridCoordinate gridLocation, EPipeType* pipeType, int* pipeClass, PipeDirections* connections);
-    void UpdatePipeConnections(const FPipeGridCoordinate& coordinate);
-
-    void GetCurrentPlaced(std::vector<PipeSegmentGenerated>& realizedPipes);
-    bool GetAnyPipesPlaced();
-    bool GetAnyPlacedPipesDisconnected();
-    int32 GetActionablePipesCount();
-
-    void ReturnDisconnectedToToolbox();
-
-    void SetRotateEnabled(bool enabled) { m_rotateEnabled = enabled; }
-    void SetDragEnabled(bool enabled) { m_dragEnabled = enabled; }
-    void SetToolboxEnabled(bool enabled) { m_toolboxEnabled = enabled; }
-
-    void SetTargetCursorEnabled(bool enabled) { TargetCursorEnabled = enabled; }
-    bool GetTargetCursorEnabled() { return TargetCursorEnabled; }
-
-    bool GetToolboxCoordinate(FPipeGridCoordinate* pCoord);
-    bool TrySetToolboxCoordinate(const FPipeGridCoordinate& coord);
-    bool IsToolboxEmpty();
-    bool ToolboxAvailable();
-    bool CoordinateInToolbox(const FPipeGridCoordinate& coordinate);
-    FPipeGridCoordinate GetDefaultToolboxCoordinate(int playableGridSize);
-
-    void FinalizeLevel();
-    
-    UFUNCTION(BlueprintCallable)
-    void SetInteractionEnabled(bool enabled);
-
-    UFUNCTION(BlueprintCallable)
-    bool GetInteractionEnabled() { return m_hands.InteractionEnabled; }
-
-    UFUNCTION(BlueprintCallable)
-    void SetLabelsEnabled(bool enabled);
-
-    UFUNCTION(BlueprintCallable)
-    bool GetLabelsEnabled();
-
-    UFUNCTION(BlueprintImplementableEvent)
-    void OnCursorUpdated(FCursorState state);
-
-    UPROPERTY(BlueprintAssignable, Category = "GridEvents")
-    FGridSolved OnGridSolved;
-
-    UPROPERTY(BlueprintAssignable, Category = "GridEvents")
-    FGridUpdated OnGridUpdated;
-
-    UPROPERTY(BlueprintAssignable, Category = "GridEvents")
-    FToolboxMoved OnToolboxMoved;
-
-    UPROPERTY(BlueprintAssignable, Category = "GridEvents")
-    FPipeGrasped OnPipeGrasped;
-
-    UPROPERTY(BlueprintAssignable, Category = "GridEvents")
-    FPipeDropped OnPipeDropped;
-
-    UPROPERTY(BlueprintAssignable, Category = "GridEvents")
-    FRotateHandleShown OnRotateHandleShown;
-
-    // For Level Score, lower (fewer moves) is better
-    UFUNCTION(BlueprintCallable)
-    int32 GetCurrentLevelScore();
-
-    void ClearCurrentLevelScore();
-
-    // ----------------------------------------------
-    // Location Helpers (PPipeGrid_LocationHelpers)
-    // ----------------------------------------------
-
-    static FVector WorldLocationToTransformLocation(const FVector& worldLocation, const FTransform& toWorldTransform);
-    static FVector TransformLocationToWorldLocation(const FVector& transformLocation, const FTransform& toWorldTransform);
-
-    FVector WorldLocationToGridLocation(const FVector& worldLocation);
-    FVector GridLocationToWorldLocation(const FVector& gridLocation);
-
-    FPipeGridCoordinate GridLocationToGridCoordinate(const FVector& gridLocation);
-    FVector GridCoordinateToGridLocation(const FPipeGridCoordinate& gridCoordinate);
-
-    FTransform WorldTransformToGridTransform(const FTransform& worldTransform);
-
-protected:
-
-    void ChangeInteractionEnabledForHand(GridHand& hand);
-    void ClearHand(GridHand& hand);
-    void ClearHandDebounce(GridHandState& handState);
-    void ClearHandFocusHistory(GridHandFocus& handFocus);
-
-    bool CheckForSolution();
-    bool ResolveGridState();
-
-	// Called when the game starts or when spawned
-	virtual void BeginPlay() override;
-
-    UFUNCTION()
-    void HandlePawnGazeUpdate(FGazeUpdate update);
-
-    UFUNCTION()
-    void HandlePawnGestureUpdate(FGestureUpdate update);
-    void HandlePawnGestureUpdateForHand(EFingerHand fingerHand, const FFingerGestureUpdate& update, GridHand& hand);
-    void HandleNoneGestureUpdate(const FFingerGestureUpdate& update, GridHand& hand);
-    void HandleFocusedGestureUpdate(const FFingerGestureUpdate& update, GridHand& hand);
-    void UpdateFocus(GridHand& hand);
-
-    UFUNCTION(BlueprintCallable)
-    bool ToggleDebugFocus();
-
-    GridPipe* GetActionablePipe(FPipeGridCoordinate gridLocation);
-
-    bool PipeConnected(const FPipeGridCoordinate& pipeCoordinate);
-    bool PipeConnected(const GridPipe& pipe, PipeDirections direction);
-
-	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid")
-	float CellSize;
-
-	UPROPERTY(EditAnywhere, Category = "Grid")
-	TSubclassOf<APPipe> PipeClass;
-
-    UPROPERTY(EditAnywhere, Category = "Grid")
-    TSubclassOf<APToolbox> ToolboxClass;
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid")
-    APToolbox* Toolbox;
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid")
-    APMRPawn* Pawn;
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
-    bool TargetCursorEnabled;
-
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid")
-    float MinGridScale;
-
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid")
-    float MaxGridScale;
-
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Debounce")
-    float ShowRotateHandlesTimeout;
-
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Debounce")
-    float LoseRotateFocusTimeout;
-
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Debounce")
-    float ChangeRotateAxisTimeout;
-
-    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Debounce")
-    float FocusGutterRatio;
-
-	std::unordered_map<FPipeGridCoordinate, GridPipe, std::function<size_t(const FPipeGridCoordinate&)>> m_pipesGrid;
-    std::list<GridPipe*> m_openList;
-
-    GridHands m_hands;
-
-    bool m_labelsEnabled;
-
-#if !UE_BUILD_SHIPPING
-    bool m_debugFocus = false;
-#endif
-
-    // ----------------------------------------------
-    // Toolbox (PPipeGrid_Toolbox)
-    // ----------------------------------------------
-
-    void InitializeToolboxPipes();
-    
-    bool TryHandleStartToolboxDrag(GridHandState& handState); 
-    void HandleToolboxGestureUpdate(const FFingerGestureUpdate& update, GridHandState& handState);
-    void HandleToolboxDragLost(GridHandState& handState);
-
-    bool IsToolboxDragging();
-    bool IsToolboxFocused();
-    bool DoesToolboxFitAt(FPipeGridCoordinate root);
-
-    void LiftToolbox();
-    void DropToolbox(FPipeGridCoordinate root);
-
-    void EnsureToolboxPipes();
-    void SpawnInToolbox(EPipeType toolboxPipe);
-    bool ToolboxCoordinateForType(EPipeType type, FPipeGridCoordinate* pCoord);
-    bool ToolboxCoordinateForType(EPipeType type, FPipeGridCoordinate root, FPipeGridCoordinate* pCoord);
-
-    bool m_toolboxEnabled = true;
-    
-    // ----------------------------------------------
-    // Translate Pipe (PipeGrid_TranslatePipe)
-    // ----------------------------------------------
-
-    void HandleTranslateGestureUpdate(const FFingerGestureUpdate& update, GridHandState& handState);
-    void HandleDragLost(GridHandState& handState);
-    bool TryHandleDragStart(const FFingerGestureUpdate& update, GridHandState& handState);
-    bool CanStartDrag(GridHandState& handState);
-
-    void AttachTarget(const FFingerGestureUpdate& update, GridHandState& handState);
-    void DetachTarget(GridHandState& handState);
-    FVector GetEffectiveTarget(const FFingerGestureUpdate& update, GridHandState& handState);
-
-    bool CanDropPipeAtCoordinate(const FPipeGridCoordinate& coordinate, const GridHandState& handState, bool* intoToolbox);
-
-    bool m_dragEnabled = true;
-
-    // ----------------------------------------------
-    // Rotate Pipe (PPipeGrid_RotatePipe)
-    // ----------------------------------------------
-
-    void HandleRotateGestureUpdate(const FFingerGestureUpdate& update, GridHandState& handState);
-    void HandleRotateUpdate(GridHandState& handState, const FVector& gridLocation);
-    bool TryHandleRotateStart(GridHandState& handState); 
-    void HandleRotateLost(GridHandState& handState);
-    void ComputeCurrentRotationHandle(const FPipeGridCoordinate& pipeGridCoord, const GridHandState& handState, EInteractionAxis* pHandleAxis, FVector* pHandleLocation);
-    void ComputeCurrentRotationHandle(const FPipeGridCoordinate& pipeGridCoord, const GridHandState& handState, EInteractionAxis preferrdAxis, EInteractionAxis* pHandleAxis, FVector* pHandleLocation);
-
-    void ComputeCandidateRotations(GridHandState& handState, const FVector& gridLocation, float* yaw, float* pitch, float* roll);
-    float ComputeCandidateRotation(const FVector& base, const FVector& current, const FVector& mask); 
-
-    bool RotateEngaged(const FPipeGridCoordinate& location);
-    bool ShowingRotateHandles(GridHandState& handState);
-
-    bool m_rotateEnabled = true;
-
-    // ----------------------------------------------
-    // Cursor (PPipeGrid_Cursor)
-    // ----------------------------------------------
-
-    void UpdateCursor();
-    void UpdateCursorForHand(GridHandState& handState, FCursorStateHand& cursorState);
-    void SendCursorUpdate(const FCursorState& newState, bool forceDirty = false);
-    bool ProcessCursorUpdatesForHand(const FCursorStateHand& newState, FCursorStateHand& state, bool forceDirty);
-    void UpdateCursorProxy(const FConnectionsCursorState& cursorState, GridHandState& hand);
-    
-    // ----------------------------------------------
-    // Place World (PPipeGrid_PlaceWorld)
-    // ----------------------------------------------
-
-    UFUNCTION(BlueprintCallable)
-    void EnablePlaceWorld(bool enabled);
-
-
-    UFUNCTION(BlueprintCallable)
-    bool GetPlaceWorldEnabled();
-
-    void HandlePlaceWorldGestureUpdate(const FGestureUpdate& update);
-
-    PlaceWorldState m_placeWorldState;
-
-    // ----------------------------------------------
-    // Score (PPipeGrid_Score)
-    // ----------------------------------------------
-
-    void ScoreHandGrasp(EFingerHand hand, const APPipe* graspedPipe);
-    void ScoreHandRelease(EFingerHand hand, const APPipe* releasedPipe);
-
-    GridScore m_score = {};
-
-    // ----------------------------------------------
-    // Gaze (PPipeGrid_Gaze)
-    // ----------------------------------------------
-
-    enum class MarkPipesForGazeMode
-    {
-        ClearAll,
-        MarkGazed,
-    };
-
-    void UpdateGaze(const FGazeUpdate& worldSpaceGaze);
-    bool GazeIntersectsCoordinate(const FPipeGridCoordinate& coordinate, FVector* position);
-    bool GazeIntersectsAABB(const FVector& minAABB, const FVector& maxAABB, FVector* position);
-    bool FindMinDistanceFromGaze(const FVector& position, float* distance);
-    bool FindMinDistanceFromGazeSq(const FVector& position, float* distance);
-    void MarkPipesForGaze(MarkPipesForGazeMode mode);
-
-    FGazeUpdate m_gaze;
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "PPipe.h"
+#include "PMRPawn.h"
+#include "PToolbox.h"
+#include "PPipeGrid_PlaceWorld.h"
+#include "PPipeGrid_GridHands.h"
+#include "PPipeGrid_Cursor.h"
+#include "PPipeGrid_Interaction.h"
+#include "PPipeGrid_Score.h"
+#include "PPipeGrid_Storage.h"
+#include "PPipeGrid_Replay.h"
+#include "PPipeGrid_Journal.h"
+#include "PPipeGrid_AsyncResolve.h"
+#include "PPipeGrid.generated.h"
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FGridSolved);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FGridUpdated);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FToolboxMoved);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FPipeGrasped, FPipeGridCoordinate, graspLocation);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FPipeDropped, FPipeGridCoordinate, dropLocation);
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_TwoParams(FRotateHandleShown, FPipeGridCoordinate, pipeLocation, EInteractionAxis, axis);
+
+enum class AddPipeOptions
+{
+    None                = 0x00,
+    InToolbox           = 0x01, // For internal use only
+    Fixed               = 0x02,
+    FromToolbox         = 0x04
+}; 
+
+DEFINE_ENUM_FLAG_OPERATORS(AddPipeOptions);
+
+// The grid keeps the coordinates of the pipes in each of these sets, so the game can ask about them
+// without walking the whole grid. A pipe is in at most one of Placed, Toolbox and Fixed
+enum class GridPipeSet : uint8
+{
+    Placed,             // Put in the grid by the player
+    Toolbox,            // Waiting in the toolbox
+    Fixed,              // Part of the level, or a toolbox pipe that has run out
+    PlacedDisconnected, // Placed, but not connected to a start or end
+
+    Count
+};
+
+struct GridPipe
+{
+    APPipe* pipe;
+    FPipeGridCoordinate currentLocation;
+    int currentPipeClass;
+
+    // What this pipe currently adds to the grid's running connectivity totals
+    int openConnections = 0;
+    bool disconnected = false;
+
+    // Marks pipes already visited by the current incremental resolve
+    uint32 resolveStamp = 0;
+
+    // Where this pipe is in each of the grid's pipe sets, or -1 if it isn't in it
+    int32 setIndex[static_cast<int>(GridPipeSet::Count)] = { -1, -1, -1, -1 };
+};
+
+UCLASS()
+class HOLOPIPES_API APPipeGrid : public AActor
+{
+	GENERATED_BODY()
+	
+public:
+
+	// Sets default values for this actor's properties
+	APPipeGrid();
+
+    UFUNCTION(BlueprintCallable)
+	void Clear();
+
+    void SetPawn(APMRPawn* pawn);
+
+    void InitializeToolbox(const std::vector<PipeSegmentGenerated>& pipesInToolbox, int playableGridSize);
+    void AddToToolbox(const std::vector<PipeSegmentGenerated>& pipesInToolbox);
+    void RemoveToolbox();
+
+    void AddPipes(const std::vector<PipeSegmentGenerated>& pipes, AddPipeOptions options);
+	void AddPipe(const PipeSegmentGenerated& pipeToAdd, AddPipeOptions options);
+
+    // Adds the pipes over the coming frames rather than all at once, spending at most PopulateBudgetMs
+    // a frame and starting with the ones nearest the gaze. Batches go in in the order they're queued,
+    // and interaction stays off until the last one is in
+    void QueuePipes(const std::vector<PipeSegmentGenerated>& pipes, AddPipeOptions options);
+    bool IsPopulating() const;
+    void FinishPopulation();
+
+    void GetPipeInfo(FPipeGridCoordinate gridLocation, EPipeType* pipeType, int* pipeClass, PipeDirections* connections);
+    void UpdatePipeConnections(const FPipeGridCoordinate& coordinate);
+
+    void GetCurrentPlaced(std::vector<PipeSegmentGenerated>& realizedPipes);
+    bool GetAnyPipesPlaced();
+    bool GetAnyPlacedPipesDisconnected();
+    int32 GetActionablePipesCount();
+
+    void ReturnDisconnectedToToolbox();
+
+    void SetRotateEnabled(bool enabled) { m_rotateEnabled = enabled; }
+    void SetDragEnabled(bool enabled) { m_dragEnabled = enabled; }
+    void SetToolboxEnabled(bool enabled) { m_toolboxEnabled = enabled; }
+
+    void SetTargetCursorEnabled(bool enabled) { TargetCursorEnabled = enabled; }
+    bool GetTargetCursorEnabled() { return TargetCursorEnabled; }
+
+    bool GetToolboxCoordinate(FPipeGridCoordinate* pCoord);
+    bool TrySetToolboxCoordinate(const FPipeGridCoordinate& coord);
+    bool IsToolboxEmpty();
+    bool ToolboxAvailable();
+    bool CoordinateInToolbox(const FPipeGridCoordinate& coordinate);
+    FPipeGridCoordinate GetDefaultToolboxCoordinate(int playableGridSize);
+
+    void FinalizeLevel();
+    
+    UFUNCTION(BlueprintCallable)
+    void SetInteractionEnabled(bool enabled);
+
+    UFUNCTION(BlueprintCallable)
+    bool GetInteractionEnabled() { return m_hands.InteractionEnabled; }
+
+    UFUNCTION(BlueprintCallable)
+    void SetLabelsEnabled(bool enabled);
+
+    UFUNCTION(BlueprintCallable)
+    bool GetLabelsEnabled();
+
+    UFUNCTION(BlueprintImplementableEvent)
+    void OnCursorUpdated(FCursorState state);
+
+    UPROPERTY(BlueprintAssignable, Category = "GridEvents")
+    FGridSolved OnGridSolved;
+
+    UPROPERTY(BlueprintAssignable, Category = "GridEvents")
+    FGridUpdated OnGridUpdated;
+
+    UPROPERTY(BlueprintAssignable, Category = "GridEvents")
+    FToolboxMoved OnToolboxMoved;
+
+    UPROPERTY(BlueprintAssignable, Category = "GridEvents")
+    FPipeGrasped OnPipeGrasped;
+
+    UPROPERTY(BlueprintAssignable, Category = "GridEvents")
+    FPipeDropped OnPipeDropped;
+
+    UPROPERTY(BlueprintAssignable, Category = "GridEvents")
+    FRotateHandleShown OnRotateHandleShown;
+
+    // For Level Score, lower (fewer moves) is better
+    UFUNCTION(BlueprintCallable)
+    int32 GetCurrentLevelScore();
+
+    void ClearCurrentLevelScore();
+
+    // Called by the grid's pipes the first time their state changes in a frame. The grid sends
+    // their Blueprint events once a frame, at the end of its tick (see APPipe::FlushPipeEvents)
+    void QueuePipeEvents(APPipe* pipe);
+
+    // ----------------------------------------------
+    // Location Helpers (PPipeGrid_LocationHelpers)
+    // ----------------------------------------------
+
+    static FVector WorldLocationToTransformLocation(const FVector& worldLocation, const FTransform& toWorldTransform);
+    static FVector TransformLocationToWorldLocation(const FVector& transformLocation, const FTransform& toWorldTransform);
+
+    FVector WorldLocationToGridLocation(const FVector& worldLocation);
+    FVector GridLocationToWorldLocation(const FVector& gridLocation);
+
+    FPipeGridCoordinate GridLocationToGridCoordinate(const FVector& gridLocation);
+    FVector GridCoordinateToGridLocation(const FPipeGridCoordinate& gridCoordinate);
+
+    FTransform WorldTransformToGridTransform(const FTransform& worldTransform);
+
+    // The grid's actor transform and its inverse, kept until the grid is next moved. The root
+    // component tells us whenever it moves, rotates or scales
+    const FTransform& GetGridToWorld();
+    const FTransform& GetWorldToGrid();
+    void MarkGridTransformDirty();
+    void HandleRootTransformUpdated(USceneComponent* updatedComponent, EUpdateTransformFlags updateTransformFlags, ETeleportType teleport);
+
+    // ----------------------------------------------
+    // Input Replay (PPipeGrid_Replay)
+    // ----------------------------------------------
+
+    // Records the gaze and gestures the grid receives until StopInputRecording, along with what it takes
+    // to rebuild the level as it stands (the caller says how the level was generated). Recording stops
+    // by itself if the grid is cleared. These return false (and do nothing) in shipping builds
+    bool StartInputRecording(const FGenerateOptions& options, bool buildSolution, const LevelFingerprint& fingerprint);
+    bool StopInputRecording(const FString& path);
+    bool IsRecordingInput() const;
+
+    // Rebuilds the level a recording was made on, in place of the current one, and feeds the recording
+    // back as fast as it will go with simulated time. Logs what the frames spent on gaze, focus, drag,
+    // rotate, cursor and resolve, and writes it per frame to csvPath unless that's empty. Returns false
+    // if the recording can't be replayed, and always in shipping builds
+    UFUNCTION(BlueprintCallable)
+    bool ReplayInput(const FString& path, const FString& csvPath);
+
+    // ----------------------------------------------
+    // Journal (PPipeGrid_Journal)
+    // ----------------------------------------------
+
+    // Takes back the player's last change to the grid (a drag, a rotate, a toolbox move, or a sweep of
+    // disconnected pipes into the toolbox), or makes the last one taken back again. Only the changed
+    // pipes are re-resolved. These return false when there's nothing to undo or redo, and while a pipe
+    // or the toolbox is held
+    UFUNCTION(BlueprintCallable)
+    bool Undo();
+
+    UFUNCTION(BlueprintCallable)
+    bool Redo();
+
+    UFUNCTION(BlueprintCallable)
+    bool CanUndo();
+
+    UFUNCTION(BlueprintCallable)
+    bool CanRedo();
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Undo")
+    EUndoScoring UndoScoring;
+
+    // Added to the level score by each undo and redo when UndoScoring is Penalty
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Undo")
+    int32 UndoScorePenalty;
+
+protected:
+
+#if WITH_DEV_AUTOMATION_TESTS
+    // The checks in HoloPipesTests.cpp drive the grid's internals directly
+    friend class FPipeGridIncrementalResolveTest;
+    friend class FPipeGridGazeIntersectionTest;
+    friend class FPipeGridReplayTest;
+    friend class FPipeGridJournalTest;
+#endif
+
+    void ChangeInteractionEnabledForHand(GridHand& hand);
+    void ClearHand(GridHand& hand);
+    void ClearHandDebounce(GridHandState& handState);
+    void ClearHandFocusHistory(GridHandFocus& handFocus);
+
+    bool CheckForSolution();
+    bool ResolveGridState();
+
+    // Incremental resolution. Call MarkConnectivityDirty before placing, removing or rotating
+    // the pipe at a coordinate; ResolveGridChanges then re-resolves only the pipes connected to
+    // the marked coordinates and their neighbors, and keeps the open connection and disconnected
+    // pipe counts as running totals. ResolveGridState does the same work for the whole grid
+    void MarkConnectivityDirty(const FPipeGridCoordinate& coordinate);
+    bool ResolveGridChanges();
+
+    bool IsConnectivityNode(const GridPipe& gridPipe);
+    void ResolveComponent(GridPipe& first);
+    void WalkOpenList();
+    void FinishResolvingPipe(GridPipe& gridPipe);
+    bool IsResolvedSolution();
+
+    virtual void PostInitializeComponents() override;
+
+	// Called when the game starts or when spawned
+	virtual void BeginPlay() override;
+
+    virtual void Tick(float DeltaSeconds) override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+    void FlushPipeEvents();
+
+    // Pipes waiting on FlushPipeEvents, and the list being flushed (kept to reuse its allocation)
+    std::vector<TWeakObjectPtr<APPipe>> m_pipeEventQueue;
+    std::vector<TWeakObjectPtr<APPipe>> m_pipeEventsFlushing;
+
+    UFUNCTION()
+    void HandlePawnGazeUpdate(FGazeUpdate update);
+
+    UFUNCTION()
+    void HandlePawnGestureUpdate(FGestureUpdate update);
+    void HandlePawnGestureUpdateForHand(EFingerHand fingerHand, const FFingerGestureUpdate& update, GridHand& hand);
+    void HandleNoneGestureUpdate(const FFingerGestureUpdate& update, GridHand& hand);
+    void HandleFocusedGestureUpdate(const FFingerGestureUpdate& update, GridHand& hand);
+    void UpdateFocus(GridHand& hand);
+
+    UFUNCTION(BlueprintCallable)
+    bool ToggleDebugFocus();
+
+    // When on, every incremental resolve is checked against a full one and mismatches are logged.
+    // Returns false (and does nothing) in shipping builds
+    UFUNCTION(BlueprintCallable)
+    bool ToggleDebugResolve();
+
+    GridPipe* GetActionablePipe(FPipeGridCoordinate gridLocation);
+
+    bool PipeConnected(const FPipeGridCoordinate& pipeCoordinate);
+    bool PipeConnected(const GridPipe& pipe, PipeDirections direction);
+
+	UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid")
+	float CellSize;
+
+	UPROPERTY(EditAnywhere, Category = "Grid")
+	TSubclassOf<APPipe> PipeClass;
+
+    UPROPERTY(EditAnywhere, Category = "Grid")
+    TSubclassOf<APToolbox> ToolboxClass;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid")
+    APToolbox* Toolbox;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Grid")
+    APMRPawn* Pawn;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
+    bool TargetCursorEnabled;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid")
+    float MinGridScale;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Grid")
+    float MaxGridScale;
+
+    // How long a frame may spend adding queued pipes and releasing cleared ones
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
+    float PopulateBudgetMs;
+
+    // Grids with at least this many entries are fully resolved (when a level is finalized, or labels
+    // are turned on or off) on worker threads instead of the game thread. 0 always resolves in place
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Grid")
+    int32 AsyncResolveMinPipes;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Debounce")
+    float ShowRotateHandlesTimeout;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Debounce")
+    float LoseRotateFocusTimeout;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Debounce")
+    float ChangeRotateAxisTimeout;
+
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Debounce")
+    float FocusGutterRatio;
+
+    PipeGridStorage<GridPipe> m_pipesGrid;
+    std::list<GridPipe*> m_openList;
+
+    std::vector<FPipeGridCoordinate> m_dirtyConnectivity;
+    std::vector<GridPipe*> m_resolveComponent;
+    int m_openConnections = 0;
+    int m_disconnectedPipes = 0;
+    uint32 m_resolveStamp = 0;
+
+    // Call IndexPipe after anything that could move a pipe between sets: fixing it, taking it out of the
+    // toolbox, or resolving its class. PutGridPipe and EraseGridPipe keep the sets up to date as entries
+    // are added to and removed from m_pipesGrid, and should be used instead of changing it directly
+    void IndexPipe(GridPipe& gridPipe);
+    void UnindexPipe(GridPipe& gridPipe);
+    GridPipe& PutGridPipe(const GridPipe& gridPipe);
+    PipeGridStorage<GridPipe>::iterator EraseGridPipe(PipeGridStorage<GridPipe>::iterator it);
+
+    std::vector<FPipeGridCoordinate> m_pipeSets[static_cast<int>(GridPipeSet::Count)];
+
+    // Bumped by anything that adds, removes or rotates a connectivity node, which is what an async
+    // resolve needs to know to tell whether its copy of the grid is still good
+    uint32 m_connectivityGeneration = 0;
+
+    GridHands m_hands;
+
+    bool m_labelsEnabled;
+
+    FTransform m_gridToWorld = FTransform::Identity;
+    FTransform m_worldToGrid = FTransform::Identity;
+    bool m_gridTransformDirty = true;
+
+#if !UE_BUILD_SHIPPING
+    bool m_debugFocus = false;
+    bool m_debugResolve = false;
+
+    bool VerifyIncrementalResolve();
+    bool VerifyPipeSets();
+#endif
+
+    // ----------------------------------------------
+    // Toolbox (PPipeGrid_Toolbox)
+    // ----------------------------------------------
+
+    void InitializeToolboxPipes();
+    
+    bool TryHandleStartToolboxDrag(GridHandState& handState); 
+    void HandleToolboxGestureUpdate(const FFingerGestureUpdate& update, GridHandState& handState);
+    void HandleToolboxDragLost(GridHandState& handState);
+
+    bool IsToolboxDragging();
+    bool IsToolboxFocused();
+    bool DoesToolboxFitAt(FPipeGridCoordinate root);
+
+    void LiftToolbox();
+    void DropToolbox(FPipeGridCoordinate root);
+
+    void EnsureToolboxPipes();
+    void SpawnInToolbox(EPipeType toolboxPipe);
+    bool ToolboxCoordinateForType(EPipeType type, FPipeGridCoordinate* pCoord);
+    bool ToolboxCoordinateForType(EPipeType type, FPipeGridCoordinate root, FPipeGridCoordinate* pCoord);
+
+    bool m_toolboxEnabled = true;
+
+    // Where the toolbox sits, kept by InitializeToolbox and DropToolbox (which TrySetToolboxCoordinate
+    // goes through) so lookups don't have to bring its actor's location back into the grid. Lifting the
+    // toolbox leaves it alone, since nothing looks it up while the toolbox is dragged
+    FPipeGridCoordinate m_toolboxRoot = FPipeGridCoordinate::Zero;
+    bool m_haveToolboxRoot = false;
+    
+    // ----------------------------------------------
+    // Translate Pipe (PipeGrid_TranslatePipe)
+    // ----------------------------------------------
+
+    void HandleTranslateGestureUpdate(const FFingerGestureUpdate& update, GridHandState& handState);
+    void HandleDragLost(GridHandState& handState);
+    bool TryHandleDragStart(const FFingerGestureUpdate& update, GridHandState& handState);
+    bool CanStartDrag(GridHandState& handState);
+
+    void AttachTarget(const FFingerGestureUpdate& update, GridHandState& handState);
+    void DetachTarget(GridHandState& handState);
+    FVector GetEffectiveTarget(const FFingerGestureUpdate& update, GridHandState& handState);
+
+    bool CanDropPipeAtCoordinate(const FPipeGridCoordinate& coordinate, const GridHandState& handState, bool* intoToolbox);
+
+    bool m_dragEnabled = true;
+
+    // ----------------------------------------------
+    // Rotate Pipe (PPipeGrid_RotatePipe)
+    // ----------------------------------------------
+
+    void HandleRotateGestureUpdate(const FFingerGestureUpdate& update, GridHandState& handState);
+    void HandleRotateUpdate(GridHandState& handState, const FVector& gridLocation);
+    bool TryHandleRotateStart(GridHandState& handState); 
+    void HandleRotateLost(GridHandState& handState);
+    void ComputeCurrentRotationHandle(const FPipeGridCoordinate& pipeGridCoord, const GridHandState& handState, EInteractionAxis* pHandleAxis, FVector* pHandleLocation);
+    void ComputeCurrentRotationHandle(const FPipeGridCoordinate& pipeGridCoord, const GridHandState& handState, EInteractionAxis preferrdAxis, EInteractionAxis* pHandleAxis, FVector* pHandleLocation);
+
+    void ComputeCandidateRotations(GridHandState& handState, const FVector& gridLocation, float* yaw, float* pitch, float* roll);
+    float ComputeCandidateRotation(const FVector& base, const FVector& current, const FVector& mask); 
+
+    bool RotateEngaged(const FPipeGridCoordinate& location);
+    bool ShowingRotateHandles(GridHandState& handState);
+
+    bool m_rotateEnabled = true;
+
+    // ----------------------------------------------
+    // Cursor (PPipeGrid_Cursor)
+    // ----------------------------------------------
+
+    void UpdateCursor();
+    void UpdateCursorForHand(GridHandState& handState, FCursorStateHand& cursorState);
+    void SendCursorUpdate(const FCursorState& newState, bool forceDirty = false);
+    bool ProcessCursorUpdatesForHand(const FCursorStateHand& newState, FCursorStateHand& state, bool forceDirty);
+    void UpdateCursorProxy(const FConnectionsCursorState& cursorState, GridHandState& hand);
+    
+    // ----------------------------------------------
+    // Place World (PPipeGrid_PlaceWorld)
+    // ----------------------------------------------
+
+    UFUNCTION(BlueprintCallable)
+    void EnablePlaceWorld(bool enabled);
+
+
+    UFUNCTION(BlueprintCallable)
+    bool GetPlaceWorldEnabled();
+
+    void HandlePlaceWorldGestureUpdate(const FGestureUpdate& update);
+
+    PlaceWorldState m_placeWorldState;
+
+    // ----------------------------------------------
+    // Score (PPipeGrid_Score)
+    // ----------------------------------------------
+
+    // Returns whether the grasp added to the score
+    bool ScoreHandGrasp(EFingerHand hand, const APPipe* graspedPipe);
+    void ScoreHandRelease(EFingerHand hand, const APPipe* releasedPipe);
+    void ScoreUndo(int32 scoredGrasps, bool undo);
+
+    GridScore m_score = {};
+
+    // ----------------------------------------------
+    // Journal (PPipeGrid_Journal)
+    // ----------------------------------------------
+
+    // Called as the player finishes changing the grid. Changes the journal can't hold (see
+    // GridJournalEntry::CanPack) clear it instead, since nothing before them could be undone correctly
+    void JournalDrag(const GridHandState& handState, const FPipeGridCoordinate& dragEnd, bool toolboxDrop);
+    void JournalRotate(const GridHandState& handState);
+    void JournalToolboxMove(const FPipeGridCoordinate& from, const FPipeGridCoordinate& to);
+    void JournalChange(const GridJournalEntry& entry);
+    void ClearJournal();
+
+    bool CanApplyJournal();
+    // Applies journal entries first..last as one change. If one fails, the ones already applied are
+    // taken back and this returns false
+    bool ApplyJournalGroup(int32 first, int32 last, bool undo, int32& scoredGrasps);
+    bool ApplyJournalEntry(const GridJournalEntry& entry, bool undo);
+    bool JournalMovePipe(const FPipeGridCoordinate& from, const FPipeGridCoordinate& to, PipeDirections directions);
+    bool JournalTakePipe(EPipeType type, const FPipeGridCoordinate& to, PipeDirections directions);
+    bool JournalReturnPipe(EPipeType type, const FPipeGridCoordinate& from);
+    void FinishApplyingJournal(bool applied, int32 scoredGrasps, bool undo);
+
+    GridJournal m_journal;
+
+    // ----------------------------------------------
+    // Population (PPipeGrid_Population)
+    // ----------------------------------------------
+
+    struct PopulationBatch
+    {
+        std::vector<PipeSegmentGenerated> Pipes;
+        AddPipeOptions Options;
+
+        // The gaze the pipes were last sorted for, if they have been
+        FGazeUpdate SortedForGaze = {};
+        bool Sorted = false;
+    };
+
+    void UpdatePopulation();
+    bool PopulateNext();
+
+    // Sorts the batch nearest the gaze last, unless it's already sorted for roughly this gaze
+    void SortPopulationBatchByGaze(PopulationBatch& batch);
+
+    std::vector<PopulationBatch> m_populationBatches;
+
+    // Pipes from the last Clear, still waiting to be released
+    std::vector<TWeakObjectPtr<APPipe>> m_retiringPipes;
+
+    bool m_enableInteractionWhenPopulated = false;
+
+    // ----------------------------------------------
+    // Pipe Pool (PPipeGrid_PipePool)
+    // ----------------------------------------------
+
+    // Pipes that leave play are deactivated and kept, one pool per pipe type, for the next pipe of
+    // that type to be initialized into, instead of being destroyed and spawned again
+    APPipe* AcquirePipe(EPipeType type);
+    void ReleasePipe(APPipe* pipe);
+    void ReleaseProxy(GridHandProxy& proxy);
+    void DestroyPipePool();
+
+    static constexpr int PipePoolCount = 6;
+    std::vector<TWeakObjectPtr<APPipe>> m_pipePool[PipePoolCount];
+
+    // ----------------------------------------------
+    // Gaze (PPipeGrid_Gaze)
+    // ----------------------------------------------
+
+    enum class MarkPipesForGazeMode
+    {
+        ClearAll,
+        MarkGazed,
+    };
+
+    // A cell whose focus gutter (FocusGutterRatio times the cell size) the gaze ray passes through
+    struct GazeCell
+    {
+        FPipeGridCoordinate Coordinate;
+
+        // How far along the gaze the ray enters the gutter
+        float Distance;
+
+        // Whether the ray passes through the cell itself, and not just its gutter
+        bool Direct;
+    };
+
+    void UpdateGaze(const FGazeUpdate& worldSpaceGaze);
+    // Finds the cells near the gaze, within the given (inclusive) bounds grown by the focus gutter
+    void TraverseGaze(const FPipeGridCoordinate& boundsMin, const FPipeGridCoordinate& boundsMax);
+    bool GazeNearCoordinate(const FPipeGridCoordinate& coordinate);
+    bool GazeIntersectsCoordinate(const FPipeGridCoordinate& coordinate, FVector* position);
+    bool GazeIntersectsAABB(const FVector& minAABB, const FVector& maxAABB, FVector* position);
+
+    // Tests up to GazeBatchSize boxes against the gaze at once. Bit i of the result is set if box i
+    // is hit, in which case positions[i] (and distances[i], if given) say where the gaze enters it.
+    // A gaze that starts inside a box enters it at its origin
+    static constexpr int32 GazeBatchSize = 4;
+    uint32 GazeIntersectsAABBs(const FVector* minAABBs, const FVector* maxAABBs, int32 count, FVector* positions, float* distances = nullptr);
+    bool FindMinDistanceFromGaze(const FVector& position, float* distance);
+    bool FindMinDistanceFromGazeSq(const FVector& position, float* distance);
+    void MarkPipesForGaze(MarkPipesForGazeMode mode);
+
+    FGazeUpdate m_gaze;
+
+    // Cells near the gaze ray inside the play area, in order along the ray, and the same cells
+    // sorted by coordinate for lookups. Rebuilt with each gaze update
+    std::vector<GazeCell> m_gazeCells;
+    std::vector<FPipeGridCoordinate> m_gazeCellLookup;
+    std::vector<FPipeGridCoordinate> m_gazeTraversed;
+    FPipeGridCoordinate m_gazeBoundsMin = FPipeGridCoordinate::Zero;
+    FPipeGridCoordinate m_gazeBoundsMax = FPipeGridCoordinate::Zero;
+    bool m_haveGazeCells = false;
+
+    // The (inclusive) range of coordinates that make up the play area, set by InitializeToolbox and
+    // empty until then. Pipes can sit outside of it (the toolbox can be dragged anywhere)
+    FPipeGridCoordinate m_playBoundsMin = FPipeGridCoordinate::Zero;
+    FPipeGridCoordinate m_playBoundsMax = { -1, -1, -1 };
+
+    std::vector<FPipeGridCoordinate> m_gazeMarked;
+
+    // ----------------------------------------------
+    // Async Resolve (PPipeGrid_AsyncResolve)
+    // ----------------------------------------------
+
+    // Resolves the whole grid like ResolveGridState, on worker threads when the grid has at least
+    // AsyncResolveMinPipes entries and in place otherwise. Until the result is applied, by
+    // UpdateAsyncResolve, ResolveGridChanges holds on to the changes it's given and reports no
+    // solution. A result the grid has changed under is thrown away and the resolve started again
+    void ResolveGridStateAsync();
+    bool IsAsyncResolvePending();
+    void UpdateAsyncResolve(bool wait);
+    void ApplyAsyncResolve(const AsyncResolveJob& job);
+    void CancelAsyncResolve();
+
+    AsyncResolveState m_asyncResolve;
+
+    // ----------------------------------------------
+    // Input Replay (PPipeGrid_Replay)
+    // ----------------------------------------------
+
+    // The time debouncing goes by, which is simulated while replaying
+    float GetInteractionTime();
+
+#if !UE_BUILD_SHIPPING
+    InteractionEnabledFlags GetInteractionEnabledFlags();
+    void RecordInput(InteractionRecord& record);
+    void RecordGaze(const FGazeUpdate& update);
+    void RecordGesture(const FGestureUpdate& update);
+    void EndInputRecording();
+
+    bool RebuildRecordedLevel(const InteractionLogHeader& header);
+    void ApplyRecordedEnabled(InteractionEnabledFlags enabled);
+
+    InteractionReplayState m_replay;
+#endif
+};
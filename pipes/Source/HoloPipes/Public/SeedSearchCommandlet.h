@@ -0,0 +1,28 @@
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Commandlets/Commandlet.h"
+#include "SeedSearchCommandlet.generated.h"
+
+/**
+ * Sweeps level seeds in parallel and reports the best scoring ones, for pinning tutorial and curated
+ * levels (see TutorialLevel::Seed). Run headless with:
+ *
+ *   UE4Editor-Cmd.exe HoloPipes -run=SeedSearch -Level=40 -FirstSeed=1 -Seeds=1000000 -TopK=10
+ *                     -Metrics=PathLength:1,Turns:0.5,Par:1 [-Workers=0] [-MemoryKB=0]
+ *                     [-GameMode=/Game/Path/To/GameMode.GameMode_C] [-Output=seeds.csv]
+ *
+ * The level number picks the generator rules (the same ones the game uses for that level), and each
+ * seed picks the layout within those rules
+ */
+UCLASS()
+class HOLOPIPES_API USeedSearchCommandlet : public UCommandlet
+{
+    GENERATED_BODY()
+
+public:
+
+    USeedSearchCommandlet();
+
+    virtual int32 Main(const FString& params) override;
+};